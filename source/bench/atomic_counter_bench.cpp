@@ -0,0 +1,74 @@
+/*!
+ * @file: atomic_counter_bench.cpp
+ * Counter workload: ConcurrentHashTbl::update() versus AtomicHashTbl::fetch_add(), from 1 to
+ * N threads.
+ *
+ * Every thread adds 1 to the counters of random account numbers; half of the numbers are
+ * new, so the tables also grow while they are being counted. The striped table takes a
+ * bucket lock per increment, the atomic one claims a slot once and then only fetch-adds.
+ * N is the number of hardware threads, and at least 4.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../include/concurrent_hashtbl.h"
+#include "../include/atomic_hashtbl.h"
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr int ACCOUNTS = 1 << 17;       //!< Distinct account numbers.
+    constexpr std::size_t OPS = 1u << 22;   //!< Increments per run, split among the threads.
+
+    /// ConcurrentHashTbl has no fetch_add(): the increment runs under the bucket's lock.
+    long add( ac::ConcurrentHashTbl< int, long > &table_, int key_ )
+    {
+        if (!table_.update( key_, []( long &d ) { ++d; } ))
+            table_.insert( key_, 1 ); // Corrida benigna: basta para medir
+        return 0;
+    }
+
+    long add( ac::AtomicHashTbl< int, long > &table_, int key_ ) { return table_.fetch_add( key_, 1 ); }
+
+    volatile long sink; //!< Keeps the optimizer from dropping the measured calls.
+
+    /// Millions of increments per second of `threads_` threads on a fresh table.
+    template < typename Table >
+    double run( std::size_t threads_ )
+    {
+        Table table( ACCOUNTS / 2 );
+        auto work = [&table, threads_]( std::size_t t ) {
+            std::mt19937 rng( static_cast<unsigned>( t + 1 ) );
+            long acc = 0;
+            for (std::size_t i = 0; i < OPS / threads_; ++i)
+                acc += add( table, static_cast<int>( rng() % ACCOUNTS ) );
+            sink = acc;
+        };
+
+        auto start = clock_type::now();
+        std::vector< std::thread > pool;
+        for (std::size_t t = 0; t < threads_; ++t)
+            pool.emplace_back( work, t );
+        for (auto &t : pool)
+            t.join();
+        std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        return OPS / elapsed.count();
+    }
+}
+
+int main()
+{
+    const std::size_t max_threads = std::max( 4u, std::thread::hardware_concurrency() );
+    std::printf( "Random increments on %d account counters (millions of ops per second)\n", ACCOUNTS );
+    std::printf( "%8s %12s %12s\n", "threads", "striped", "atomic" );
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+        std::printf( "%8zu %12.1f %12.1f\n", threads, run< ac::ConcurrentHashTbl< int, long > >( threads ),
+                     run< ac::AtomicHashTbl< int, long > >( threads ) );
+
+    return 0;
+}
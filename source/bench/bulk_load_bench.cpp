@@ -0,0 +1,84 @@
+/*!
+ * @file: bulk_load_bench.cpp
+ * Building a chained HashTbl from a vector of entries: insert() one at a time, with and
+ * without reserve(), against insert_bulk() with and without the uniqueness promise.
+ *
+ * Keys are random, so a plain insert loop writes all over the bucket array and rehashes
+ * every time the table doubles. insert_bulk() sizes the table once and inserts partition by
+ * partition, each partition a cache-sized slice of the bucket array.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../include/hashtbl.h"
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+    using key_type = std::uint64_t;
+    using table_type = ac::HashTbl< key_type, key_type >;
+
+    /// Time, in milliseconds, of one call to `fn_`.
+    template < typename Fn >
+    double time_ms( Fn fn_ )
+    {
+        auto start = clock_type::now();
+        fn_();
+        std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+        return elapsed.count();
+    }
+
+    volatile std::size_t sink; //!< Keeps the optimizer from dropping the measured calls.
+
+    void run( std::size_t n_ )
+    {
+        std::mt19937_64 rng{ 42 };
+        std::vector< table_type::entry_type > entries;
+        entries.reserve( n_ );
+        for (std::size_t i = 0; i < n_; ++i)
+            entries.emplace_back( rng(), i );
+
+        double loop = time_ms( [&] {
+            table_type table;
+            for (const auto &e : entries)
+                table.insert( e.m_key, e.m_data );
+            sink = table.size();
+        } );
+        double reserved = time_ms( [&] {
+            table_type table;
+            table.reserve( n_ );
+            for (const auto &e : entries)
+                table.insert( e.m_key, e.m_data );
+            sink = table.size();
+        } );
+        double bulk = time_ms( [&] {
+            table_type table( entries.begin(), entries.end() );
+            sink = table.size();
+        } );
+        double unique = time_ms( [&] {
+            table_type table;
+            sink = table.insert_bulk( entries.begin(), entries.end(), true );
+        } );
+        double threaded = time_ms( [&] {
+            table_type table;
+            sink = table.insert_bulk( entries.begin(), entries.end(), true, 0 );
+        } );
+
+        std::printf( "%10zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", n_, loop, reserved, bulk, unique, threaded );
+    }
+}
+
+int main()
+{
+    std::printf( "Building a table from random keys (ms); threaded uses %u hardware threads\n",
+                 std::thread::hardware_concurrency() );
+    std::printf( "%10s %10s %10s %10s %10s %10s\n", "keys", "insert", "reserve", "bulk", "unique", "threaded" );
+    for (std::size_t n : { 1u << 16, 1u << 20, 1u << 23 })
+        run( n );
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*!
+ * @file: concurrent_bench.cpp
+ * Throughput of a HashTbl behind one mutex versus ConcurrentHashTbl, ShardedHashTbl,
+ * ReadMostlyHashTbl and LockFreeHashTbl, from 1 to N threads.
+ *
+ * Every thread runs its share of a fixed number of operations on random keys of a
+ * preloaded table: 90% retrieve() and 10% insert_or_assign(). With one mutex the threads
+ * take turns; with lock striping or sharding they only meet on the same lock, and
+ * the read-mostly and lock-free tables' lookups take no lock at all.
+ * N is the number of hardware threads, and at least 4.
+ *
+ * A first run grows each table from its default size and reports the slowest insert:
+ * HashTbl stalls on every rehash(), ShardedHashTbl only rehashes one shard at a time, and
+ * LockFreeHashTbl only doubles its bucket index.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../include/hashtbl.h"
+#include "../include/concurrent_hashtbl.h"
+#include "../include/read_mostly_hashtbl.h"
+#include "../include/lock_free_hashtbl.h"
+#include "../include/sharded_hashtbl.h"
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+    using key_type = std::uint64_t;
+
+    constexpr std::size_t KEYS = 1u << 20;  //!< Preloaded keys.
+    constexpr std::size_t OPS = 1u << 22;   //!< Operations per run, split among the threads.
+
+    /// HashTbl with every operation under one mutex: the baseline being replaced.
+    class LockedHashTbl {
+        public:
+            bool retrieve( key_type k_, key_type &d_ )
+            {
+                std::lock_guard<std::mutex> guard( m_lock );
+                return m_table.retrieve( k_, d_ );
+            }
+            bool insert_or_assign( key_type k_, key_type d_ )
+            {
+                std::lock_guard<std::mutex> guard( m_lock );
+                return m_table.insert_or_assign( k_, d_ );
+            }
+
+        private:
+            std::mutex m_lock;
+            ac::HashTbl< key_type, key_type > m_table;
+    };
+
+    volatile std::size_t sink; //!< Keeps the optimizer from dropping the measured calls.
+
+    /// Millions of operations per second of `threads_` threads sharing `table_`.
+    template < typename Table >
+    double run( Table &table_, std::size_t threads_ )
+    {
+        auto work = [&table_, threads_]( std::size_t t ) {
+            std::mt19937_64 rng{ t + 1 };
+            std::size_t found = 0;
+            key_type data = 0;
+            for (std::size_t i = 0; i < OPS / threads_; ++i)
+            {
+                const key_type key = rng() % KEYS;
+                if (i % 10 == 0)
+                    table_.insert_or_assign( key, i );
+                else
+                    found += table_.retrieve( key, data );
+            }
+            sink = found;
+        };
+
+        auto start = clock_type::now();
+        std::vector< std::thread > pool;
+        for (std::size_t t = 0; t < threads_; ++t)
+            pool.emplace_back( work, t );
+        for (auto &t : pool)
+            t.join();
+        std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        return OPS / elapsed.count();
+    }
+
+    /// Slowest single insert, in microseconds, while `table_` grows to KEYS entries.
+    template < typename Table >
+    double worst_insert_us( Table &table_ )
+    {
+        double worst = 0;
+        for (key_type k = 0; k < KEYS; ++k)
+        {
+            auto start = clock_type::now();
+            table_.insert( k, k );
+            std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+            worst = std::max( worst, elapsed.count() );
+        }
+        return worst;
+    }
+}
+
+int main()
+{
+    ac::HashTbl< key_type, key_type > growing;
+    ac::ShardedHashTbl< key_type, key_type > growing_sharded;
+    ac::LockFreeHashTbl< key_type, key_type > growing_lock_free;
+    std::printf( "Slowest insert while growing to %zu keys (microseconds)\n", KEYS );
+    std::printf( "%12s %12s %12s\n", "HashTbl", "sharded", "lock_free" );
+    const double worst = worst_insert_us( growing );
+    const double worst_sharded = worst_insert_us( growing_sharded );
+    std::printf( "%12.1f %12.1f %12.1f\n", worst, worst_sharded, worst_insert_us( growing_lock_free ) );
+
+    LockedHashTbl locked;
+    ac::ConcurrentHashTbl< key_type, key_type > striped;
+    ac::ShardedHashTbl< key_type, key_type > sharded;
+    ac::ReadMostlyHashTbl< key_type, key_type > read_mostly;
+    ac::LockFreeHashTbl< key_type, key_type > lock_free;
+    striped.reserve( KEYS );
+    sharded.reserve( KEYS );
+    read_mostly.reserve( KEYS );
+    lock_free.reserve( KEYS );
+    for (key_type k = 0; k < KEYS; ++k)
+    {
+        locked.insert_or_assign( k, k );
+        striped.insert( k, k );
+        sharded.insert( k, k );
+        read_mostly.insert( k, k );
+        lock_free.insert( k, k );
+    }
+
+    const std::size_t max_threads = std::max( 4u, std::thread::hardware_concurrency() );
+    std::printf( "\n90%% retrieve / 10%% insert_or_assign on %zu keys (millions of ops per second)\n", KEYS );
+    std::printf( "%8s %12s %12s %12s %12s %12s\n", "threads", "mutex", "striped", "sharded", "read_mostly",
+                 "lock_free" );
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+        std::printf( "%8zu %12.1f %12.1f %12.1f %12.1f %12.1f\n", threads, run( locked, threads ),
+                     run( striped, threads ), run( sharded, threads ), run( read_mostly, threads ),
+                     run( lock_free, threads ) );
+
+    return 0;
+}
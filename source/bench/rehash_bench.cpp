@@ -0,0 +1,100 @@
+/*!
+ * @file: rehash_bench.cpp
+ * Resize latency before and after the compile-time prime ladder.
+ *
+ * "Before" is the original trial-division prime search;
+ * "after" is the default PrimeModPolicy, which only searches the precomputed ladder.
+ * Bucket allocation, which both pay equally, is left out of the measurement.
+ *
+ * The second table times a full rehash and a copy of a large table against the number of
+ * threads given to rehash() and to the copy constructor.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "../include/hashtbl.h"
+
+namespace
+{
+    /// The original HashTbl::find_next_prime: trial division up to sqrt(n).
+    std::size_t trial_division_next_prime( std::size_t n_ )
+    {
+        if (n_ <= 2)
+            return 2;
+
+        bool prime = false;
+        std::size_t next_prime = n_;
+        while (!prime)
+        {
+            ++next_prime;
+            prime = true;
+            for (std::size_t i = 2; i <= std::sqrt(next_prime); ++i)
+            {
+                if (next_prime % i == 0)
+                {
+                    prime = false;
+                    break;
+                }
+            }
+        }
+        return next_prime;
+    }
+
+    using clock_type = std::chrono::steady_clock;
+
+    /// Average time, in microseconds, of `reps_` calls to `fn_`.
+    template < typename Fn >
+    double time_us( int reps_, Fn fn_ )
+    {
+        auto start = clock_type::now();
+        for (int i = 0; i < reps_; ++i)
+            fn_();
+        std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        return elapsed.count() / reps_;
+    }
+
+    volatile std::size_t sink; //!< Keeps the optimizer from dropping the measured calls.
+
+    /// Rehash (doubling, then back) and copy of `n_` string-keyed entries with `threads_` threads.
+    void parallel_run( std::size_t n_, std::size_t threads_ )
+    {
+        ac::HashTbl< std::string, std::uint64_t > table;
+        table.reserve( n_ );
+        for (std::size_t i = 0; i < n_; ++i)
+            table.insert( "key" + std::to_string( i ), i );
+
+        const std::size_t buckets = table.bucket_count();
+        double grow = time_us( 1, [&] { table.rehash( 2 * buckets, threads_ ); } );
+        double back = time_us( 1, [&] { table.rehash( buckets, threads_ ); } );
+        double copy = time_us( 1, [&] {
+            ac::HashTbl< std::string, std::uint64_t > snapshot( table, threads_ );
+            sink = snapshot.size();
+        } );
+        std::printf("%8zu %14.1f %14.1f %14.1f\n", threads_, grow / 1000, back / 1000, copy / 1000);
+    }
+}
+
+int main()
+{
+    std::printf("Next bucket count after doubling (us per call)\n");
+    std::printf("%14s %16s %16s\n", "buckets", "trial division", "prime ladder");
+    for (std::size_t n = 1 << 10; n <= (std::size_t{1} << 40); n <<= 3)
+    {
+        const int reps = n < (1 << 24) ? 1000 : 10;
+        double before = time_us(reps, [n] { sink = trial_division_next_prime(2 * n); });
+        double after = time_us(1000, [n] { sink = ac::PrimeModPolicy::bucket_count(2 * n); });
+        std::printf("%14zu %16.3f %16.3f\n", n, before, after);
+    }
+
+    const std::size_t n = std::size_t{1} << 21;
+    std::printf("\nRehash and copy of %zu entries (ms), %u hardware threads\n", n, std::thread::hardware_concurrency());
+    std::printf("%8s %14s %14s %14s\n", "threads", "grow", "shrink", "copy");
+    for (std::size_t threads : { 1, 2, 4, 8 })
+        parallel_run( n, threads );
+
+    return 0;
+}
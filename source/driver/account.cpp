@@ -42,7 +42,14 @@ bool operator==(const Account& a, const Account& b)
 std::size_t KeyHash::operator()(const Account::AcctKey& k_) const
 {
     const auto& [name, bkid, brid, accn] = k_;
-    return std::hash<std::string>{}(name) xor std::hash<int>{}(bkid) xor std::hash<int>{}(brid)
+    return (*this)(Account::AcctKeyView{name, bkid, brid, accn});
+}
+
+// std::hash of a string_view equals std::hash of the same std::string.
+std::size_t KeyHash::operator()(const Account::AcctKeyView& k_) const
+{
+    const auto& [name, bkid, brid, accn] = k_;
+    return std::hash<std::string_view>{}(name) xor std::hash<int>{}(bkid) xor std::hash<int>{}(brid)
            xor std::hash<int>{}(accn);
 }
 
@@ -53,3 +60,15 @@ bool KeyEqual::operator()(const Account::AcctKey& k1_, const Account::AcctKey& k
     const auto& [name2, bkid2, brid2, accn2] = k2_;
     return name1 == name2 and bkid1 == bkid2 and brid1 == brid2 and accn1 == accn2;
 }
+
+bool KeyEqual::operator()(const Account::AcctKey& k1_, const Account::AcctKeyView& k2_) const
+{
+    const auto& [name1, bkid1, brid1, accn1] = k1_;
+    const auto& [name2, bkid2, brid2, accn2] = k2_;
+    return name1 == name2 and bkid1 == bkid2 and brid1 == brid2 and accn1 == accn2;
+}
+
+bool KeyEqual::operator()(const Account::AcctKeyView& k1_, const Account::AcctKey& k2_) const
+{
+    return (*this)(k2_, k1_);
+}
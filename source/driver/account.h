@@ -8,6 +8,8 @@
 
 #include <functional>
 #include <iostream>
+#include <string>
+#include <string_view>
 #include <tuple>
 
 /// Represents a bank account.
@@ -20,6 +22,8 @@ struct Account {
 
     // Nickname for the account key.
     using AcctKey = std::tuple<std::string, int, int, int>;
+    // Non-owning key, for lookups that should not copy the client name.
+    using AcctKeyView = std::tuple<std::string_view, int, int, int>;
 
     /// Basic constructor.
     Account(std::string = "<empty>", int = 0, int = 0, int = 0, float = 0.f);
@@ -31,17 +35,26 @@ struct Account {
     friend std::ostream& operator<<(std::ostream& os, const Account& acct);
 };
 
+/// Stream inserter of the account key.
+std::ostream& operator<<(std::ostream& os_, const Account::AcctKey& ak_);
+
 /// Compare two accounts
 bool operator==(const Account& a, const Account& b);
 
 /// Functor that generates a hash number for a given account.
+/// Transparent: a key and its view hash alike, so tables can be probed with a view.
 struct KeyHash {
+    using is_transparent = void;
     std::size_t operator()(const Account::AcctKey&) const;
+    std::size_t operator()(const Account::AcctKeyView&) const;
 };
 
-// Functor that test two keys for equality.
+// Functor that test two keys for equality (transparent, like KeyHash).
 struct KeyEqual {
+    using is_transparent = void;
     bool operator()(const Account::AcctKey&, const Account::AcctKey&) const;
+    bool operator()(const Account::AcctKey&, const Account::AcctKeyView&) const;
+    bool operator()(const Account::AcctKeyView&, const Account::AcctKey&) const;
 };
 
 #endif
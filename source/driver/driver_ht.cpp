@@ -5,8 +5,8 @@
 #include <iostream>
 #include <tuple>
 
-#include "../include/hashtbl.h"
 #include "account.h"
+#include "../include/hashtbl.h"
 
 using namespace ac;
 
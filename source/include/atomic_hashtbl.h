@@ -0,0 +1,104 @@
+#ifndef ATOMIC_HASHTBL_H
+#define ATOMIC_HASHTBL_H
+
+#include <algorithm>    // std::min
+#include <array>        // sub-map directory
+#include <atomic>       // std::atomic
+#include <functional>   // std::hash
+#include <limits>       // std::numeric_limits
+#include <memory>       // std::unique_ptr
+#include <stdexcept>    // std::length_error, std::invalid_argument
+#include <thread>       // std::this_thread::yield
+#include <type_traits>  // std::is_integral, std::is_trivially_copyable
+
+#include "index_policy.h" // detail::next_power_of_two
+#include "hash_utils.h"   // detail::mix_hash
+
+namespace ac // Associative container
+{
+    /// Lock-free linear-probing map for integer keys and trivially copyable data, in the
+    /// style of AtomicHashMap/NonBlockingHashMap. Each slot holds an atomic key and an atomic
+    /// datum: a new key claims an empty slot with one compare-and-swap, and data are then
+    /// read and written with plain atomic loads, stores and (for integral data) fetch_add(),
+    /// so counters and indexes updated from many threads never lock and never allocate.
+    ///
+    /// The table is a chain of up to SUB_MAPS sub-maps, each twice the size of the previous
+    /// one; when a key finds no empty slot within MAX_PROBE slots of its home in every
+    /// existing sub-map, the next one is allocated and published by compare-and-swap.
+    /// Nothing is ever moved or rehashed. Erasing leaves a tombstone that is never reused.
+    ///
+    /// Three key values are reserved: the largest one (EMPTY_KEY) and the two below it.
+    /// Inserting one throws std::invalid_argument; looking one up or erasing it finds nothing.
+    /// A thread that meets a slot being claimed waits for its key, a window of two stores.
+    /// Running out of sub-maps throws std::length_error.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType > >
+    class AtomicHashTbl {
+            static_assert( std::is_integral< KeyType >::value, "AtomicHashTbl keys must be integers" );
+            static_assert( std::is_trivially_copyable< DataType >::value, "AtomicHashTbl data must be trivially copyable" );
+
+        public:
+            // Aliases
+            using size_type = std::size_t;
+
+            //! Key values that cannot be stored.
+            static constexpr KeyType EMPTY_KEY  = std::numeric_limits< KeyType >::max();
+            static constexpr KeyType LOCKED_KEY = EMPTY_KEY - 1;
+            static constexpr KeyType ERASED_KEY = EMPTY_KEY - 2;
+            //! Longest probe sequence in one sub-map, and the maximum number of sub-maps.
+            static constexpr size_type MAX_PROBE = 32;
+            static constexpr size_type SUB_MAPS = 16;
+
+            /// Sizes the first sub-map for `table_sz_` entries at a load of 80%.
+            explicit AtomicHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            AtomicHashTbl( const AtomicHashTbl & ) = delete;
+            AtomicHashTbl& operator=( const AtomicHashTbl & ) = delete;
+
+            virtual ~AtomicHashTbl();
+
+            /// Inserts, or stores `new_data_` over the data of an existing key. Returns true on insertion.
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+            /// Same as insert(); kept for symmetry with the other tables.
+            bool insert_or_assign( const KeyType & key_, const DataType & new_data_ ) { return insert( key_, new_data_ ); }
+            /// Adds `delta_` to the data of `key_`, inserting the key with `DataType{}` first if
+            /// absent. Returns the previous data. Integral data only.
+            DataType fetch_add( const KeyType & key_, DataType delta_ );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool contains( const KeyType & ) const;
+            bool erase( const KeyType & );
+            bool empty() const;
+            /// Number of entries; exact whenever no writer is running.
+            size_type size() const;
+            /// Slots in all sub-maps allocated so far.
+            size_type capacity() const;
+            /// Sub-maps allocated so far.
+            size_type sub_maps() const;
+
+        private:
+            struct Slot {
+                std::atomic< KeyType > key;
+                std::atomic< DataType > data;
+            };
+
+            struct SubMap {
+                explicit SubMap( size_type capacity_ );
+
+                const size_type mask;   //!< Capacidade - 1; a capacidade é potência de 2.
+                std::unique_ptr< Slot[] > slots;
+            };
+
+            static bool is_reserved( const KeyType & key_ ) { return key_ >= ERASED_KEY; }
+            Slot * find_slot( const KeyType & ) const;
+            Slot * claim_slot( const KeyType &, const DataType &, bool & );
+
+        private:
+            std::array< std::atomic< SubMap * >, SUB_MAPS > m_maps; //!< Sub-mapas; os nulos ainda não existem.
+            std::atomic< size_type > m_count{ 0 };                  //!< Quantidade de elementos.
+
+            static const short DEFAULT_SIZE = 16;
+    };
+
+} // namespace ac
+#include "atomic_hashtbl.inl"
+#endif
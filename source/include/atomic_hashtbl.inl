@@ -0,0 +1,246 @@
+#include "atomic_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash>
+    AtomicHashTbl<KeyType, DataType, KeyHash>::SubMap::SubMap(size_type capacity_)
+        : mask{capacity_ - 1}, slots{new Slot[capacity_]}
+    {
+        for (size_type i = 0; i < capacity_; ++i)
+        {
+            slots[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+            slots[i].data.store(DataType{}, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    AtomicHashTbl<KeyType, DataType, KeyHash>::AtomicHashTbl(size_type sz)
+    {
+        for (auto &map : m_maps)
+        {
+            map.store(nullptr, std::memory_order_relaxed);
+        }
+        m_maps[0].store(new SubMap(detail::next_power_of_two(sz + sz / 4)), std::memory_order_release);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    AtomicHashTbl<KeyType, DataType, KeyHash>::~AtomicHashTbl()
+    {
+        for (auto &map : m_maps)
+        {
+            delete map.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    bool AtomicHashTbl<KeyType, DataType, KeyHash>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        bool inserted = false;
+        Slot *slot = claim_slot(key_, new_data_, inserted);
+        if (!inserted)
+        {
+            slot->data.store(new_data_, std::memory_order_release); // A chave já existe: apenas atualiza o dado
+        }
+        return inserted;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    DataType AtomicHashTbl<KeyType, DataType, KeyHash>::fetch_add(const KeyType &key_, DataType delta_)
+    {
+        static_assert(std::is_integral<DataType>::value, "fetch_add() requires integral data");
+
+        bool inserted = false;
+        Slot *slot = claim_slot(key_, DataType{}, inserted);
+        return slot->data.fetch_add(delta_, std::memory_order_acq_rel);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    bool AtomicHashTbl<KeyType, DataType, KeyHash>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const Slot *slot = find_slot(key_);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        data_item_ = slot->data.load(std::memory_order_acquire);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    bool AtomicHashTbl<KeyType, DataType, KeyHash>::contains(const KeyType &key_) const
+    {
+        return find_slot(key_) != nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    bool AtomicHashTbl<KeyType, DataType, KeyHash>::erase(const KeyType &key_)
+    {
+        Slot *slot = find_slot(key_);
+        KeyType expected = key_;
+
+        // A lápide nunca volta a ser vazia, o que mantém válidas as sequências de sondagem
+        if (slot == nullptr || !slot->key.compare_exchange_strong(expected, ERASED_KEY, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    bool AtomicHashTbl<KeyType, DataType, KeyHash>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    typename AtomicHashTbl<KeyType, DataType, KeyHash>::size_type
+    AtomicHashTbl<KeyType, DataType, KeyHash>::size() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    typename AtomicHashTbl<KeyType, DataType, KeyHash>::size_type
+    AtomicHashTbl<KeyType, DataType, KeyHash>::capacity() const
+    {
+        size_type total = 0;
+        for (const auto &map : m_maps)
+        {
+            const SubMap *sub = map.load(std::memory_order_acquire);
+            if (sub == nullptr)
+            {
+                break;
+            }
+            total += sub->mask + 1;
+        }
+        return total;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    typename AtomicHashTbl<KeyType, DataType, KeyHash>::size_type
+    AtomicHashTbl<KeyType, DataType, KeyHash>::sub_maps() const
+    {
+        size_type n = 0;
+        while (n < SUB_MAPS && m_maps[n].load(std::memory_order_acquire) != nullptr)
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    typename AtomicHashTbl<KeyType, DataType, KeyHash>::Slot *
+    AtomicHashTbl<KeyType, DataType, KeyHash>::find_slot(const KeyType &key_) const
+    {
+        if (is_reserved(key_))
+        {
+            return nullptr; // Uma chave reservada nunca é guardada; procurá-la acharia um slot vazio
+        }
+        const size_type hash = detail::mix_hash(KeyHash()(key_));
+
+        for (const auto &map : m_maps)
+        {
+            const SubMap *sub = map.load(std::memory_order_acquire);
+            if (sub == nullptr)
+            {
+                return nullptr;
+            }
+
+            const size_type probes = std::min(MAX_PROBE, sub->mask + 1);
+            for (size_type i = 0, index = hash & sub->mask; i < probes; ++i, index = (index + 1) & sub->mask)
+            {
+                Slot &slot = sub->slots[index];
+                KeyType key = slot.key.load(std::memory_order_acquire);
+                while (key == LOCKED_KEY)
+                {
+                    std::this_thread::yield(); // Outra thread está publicando esta entrada
+                    key = slot.key.load(std::memory_order_acquire);
+                }
+
+                if (key == key_)
+                {
+                    return &slot;
+                }
+                // Slots vazios nunca voltam a sê-lo: se a chave existisse, teria ocupado este
+                if (key == EMPTY_KEY)
+                {
+                    return nullptr;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash>
+    typename AtomicHashTbl<KeyType, DataType, KeyHash>::Slot *
+    AtomicHashTbl<KeyType, DataType, KeyHash>::claim_slot(const KeyType &key_, const DataType &data_, bool &inserted_)
+    {
+        if (is_reserved(key_))
+        {
+            throw std::invalid_argument("AtomicHashTbl: reserved key");
+        }
+        const size_type hash = detail::mix_hash(KeyHash()(key_));
+
+        // Um sub-mapa só é pulado se a janela de sondagem da chave não tem slot vazio, e isso
+        // não se desfaz: duas threads com a mesma chave nunca a inserem em sub-mapas diferentes
+        for (size_type m = 0; m < SUB_MAPS; ++m)
+        {
+            SubMap *sub = m_maps[m].load(std::memory_order_acquire);
+            if (sub == nullptr)
+            {
+                SubMap *prev = m_maps[m - 1].load(std::memory_order_relaxed);
+                SubMap *fresh = new SubMap(2 * (prev->mask + 1));
+                if (m_maps[m].compare_exchange_strong(sub, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    sub = fresh;
+                }
+                else
+                {
+                    delete fresh; // Outra thread publicou o sub-mapa antes
+                }
+            }
+
+            const size_type probes = std::min(MAX_PROBE, sub->mask + 1);
+            for (size_type i = 0, index = hash & sub->mask; i < probes; ++i, index = (index + 1) & sub->mask)
+            {
+                Slot &slot = sub->slots[index];
+                KeyType key = slot.key.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    if (key == LOCKED_KEY)
+                    {
+                        std::this_thread::yield();
+                        key = slot.key.load(std::memory_order_acquire);
+                    }
+                    else if (key == EMPTY_KEY)
+                    {
+                        if (!slot.key.compare_exchange_strong(key, LOCKED_KEY, std::memory_order_acquire, std::memory_order_acquire))
+                        {
+                            continue; // Outra thread tomou o slot: reexamina com a chave dela
+                        }
+                        // O dado fica pronto antes de a chave o tornar visível
+                        slot.data.store(data_, std::memory_order_relaxed);
+                        slot.key.store(key_, std::memory_order_release);
+                        m_count.fetch_add(1, std::memory_order_relaxed);
+                        inserted_ = true;
+                        return &slot;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+
+                if (key == key_)
+                {
+                    inserted_ = false;
+                    return &slot;
+                }
+            }
+        }
+        throw std::length_error("AtomicHashTbl: out of sub-maps");
+    }
+} // Namespace ac.
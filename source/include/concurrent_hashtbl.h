@@ -0,0 +1,173 @@
+#ifndef CONCURRENT_HASHTBL_H
+#define CONCURRENT_HASHTBL_H
+
+#include <array>        // stripes
+#include <atomic>       // std::atomic
+#include <forward_list> // forward_list
+#include <functional>   // std::hash, std::equal_to
+#include <memory>       // std::allocator, std::unique_ptr
+#include <mutex>        // std::unique_lock
+#include <shared_mutex> // std::shared_mutex, std::shared_lock
+#include <thread>       // std::this_thread::yield
+
+#include "hashtbl.h"    // HashEntry, store_hash, index and growth policies
+#include "epoch.h"      // EpochDomain, EpochGuard
+
+namespace ac // Associative container
+{
+    /// Thread-safe chained hash table with lock striping. The bucket array is split into
+    /// STRIPES contiguous bucket ranges, each guarded by its own reader/writer lock padded to
+    /// a cache line: lookups share a stripe, writers take it exclusively, and operations on
+    /// different stripes never contend.
+    ///
+    /// Growing never stops the world, in the manner of Java's ConcurrentHashMap: the new
+    /// bucket array (with its own stripes) is published as the `next` of the current one,
+    /// and every writer that finds a resize under way claims a stride of old buckets and
+    /// moves them, marking each moved bucket as forwarded. An operation that meets a
+    /// forwarded bucket follows the marker into the next array; the others go on in the old
+    /// one, so only the writers of a bucket being moved ever wait for it.
+    ///
+    /// The template parameters are those of HashTbl; the allocator must be thread-safe
+    /// (std::allocator is, PoolAllocator is not). Every operation copies data in or out,
+    /// never handing out references, and update() runs a function on the data under the lock.
+    /// The table grows under its growth policy and never shrinks on its own.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType >,
+              class IndexPolicy = PrimeModPolicy,
+              class GrowthPolicy = LoadFactorPolicy,
+              class Allocator = std::allocator< HashEntry< KeyType, DataType > > >
+    class ConcurrentHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using node_type  = HashEntry<KeyType,DataType,store_hash<KeyType>::value>;
+            using allocator_type = Allocator;
+            using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc< node_type >;
+            using list_type  = std::forward_list< node_type, node_allocator >;
+            using size_type  = std::size_t;
+
+            //! Number of locks, each covering a contiguous range of buckets.
+            static constexpr size_type STRIPES = 64;
+            //! Old buckets a thread claims at a time when it helps a resize.
+            static constexpr size_type TRANSFER_STRIDE = 32;
+
+            explicit ConcurrentHashTbl( size_type table_sz_ = DEFAULT_SIZE, const GrowthPolicy & growth_ = GrowthPolicy(),
+                                        const Allocator & alloc_ = Allocator() );
+            ConcurrentHashTbl( const ConcurrentHashTbl & ) = delete;
+            ConcurrentHashTbl& operator=( const ConcurrentHashTbl & ) = delete;
+
+            virtual ~ConcurrentHashTbl();
+
+            /// Inserts, or updates the data of an existing key. Returns true on insertion.
+            bool insert( const KeyType &, const DataType & );
+            /// Inserts, or assigns `obj_` to the data of an existing key. Returns true on insertion.
+            template< class M >
+            bool insert_or_assign( const KeyType & key_, M && obj_ );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool contains( const KeyType & ) const;
+            bool erase( const KeyType & );
+            /// Calls `fn_( data )` on the data of `key_` with the key's stripe held exclusively,
+            /// so read-modify-write sequences are atomic. Returns false, without calling `fn_`,
+            /// if the key is absent. `fn_` must not call back into the table.
+            template< class Fn >
+            bool update( const KeyType & key_, Fn && fn_ );
+            void clear();
+            bool empty() const;
+            /// Sum of the element counters; exact whenever no writer is running.
+            size_type size() const;
+            /// During a resize, the size of the bucket array being emptied.
+            size_type bucket_count() const;
+            float max_load_factor() const;
+            void max_load_factor( float mlf );
+            float load_factor() const;
+            /// Makes room for `n_` elements without further growth. Never shrinks. Like rehash(),
+            /// it takes part in the move and returns once every bucket is in the new array.
+            void reserve( size_type n_ );
+            /// Sizes the table for at least `n_` buckets and the current elements.
+            void rehash( size_type n_ );
+
+        private:
+            /// A lock alone in a cache line.
+            struct alignas( detail::CACHE_LINE ) Stripe {
+                std::shared_mutex lock;
+            };
+
+            /// An element counter alone in a cache line.
+            struct alignas( detail::CACHE_LINE ) Counter {
+                std::atomic< size_type > value{ 0 };
+            };
+
+            /// A bucket array, how hashes map into it and the stripes that guard it. Once a
+            /// resize has moved every bucket to `next`, the buckets are freed and the rest is
+            /// retired to the global EpochDomain: every operation pins the epoch, so a thread
+            /// that still locks a stripe or reads a marker of the layout keeps it alive.
+            struct Layout {
+                explicit Layout( size_type size_ );
+
+                const size_type size;
+                IndexPolicy index;
+                list_type *buckets;
+                std::unique_ptr< Stripe[] > stripes;
+                std::unique_ptr< std::atomic< bool >[] > moved; //!< Marcadores de encaminhamento.
+                std::atomic< Layout * > next{ nullptr };        //!< Destino do resize em andamento.
+                std::atomic< size_type > claimed{ 0 };          //!< Próximo bucket a reivindicar.
+                std::atomic< size_type > transferred{ 0 };      //!< Buckets já movidos.
+            };
+
+            /// Holds every stripe of a layout exclusively, locked in order so two of them cannot
+            /// deadlock.
+            class AllStripes {
+                public:
+                    explicit AllStripes( Layout & layout_ ) : m_layout{ layout_ }
+                    {
+                        for (size_type s = 0; s < STRIPES; ++s)
+                            m_layout.stripes[s].lock.lock();
+                    }
+                    ~AllStripes()
+                    {
+                        for (size_type s = STRIPES; s-- > 0;)
+                            m_layout.stripes[s].lock.unlock();
+                    }
+                    AllStripes( const AllStripes & ) = delete;
+                    AllStripes & operator=( const AllStripes & ) = delete;
+
+                private:
+                    Layout & m_layout;
+            };
+
+            using shared_lock    = std::shared_lock< std::shared_mutex >;
+            using exclusive_lock = std::unique_lock< std::shared_mutex >;
+
+            static size_type hash_of( const node_type & );
+            static bool matches( const node_type &, const KeyType &, size_type );
+            static size_type stripe_of( size_type, size_type );
+            static size_type counter_of( size_type );
+            template< class Lock, class Fn >
+            decltype(auto) locked_bucket( size_type, Fn && ) const;
+            template< class Fn >
+            decltype(auto) read_growth( Fn && ) const;
+            template< class M >
+            bool insert_impl( const KeyType &, M && );
+            Layout * new_layout( size_type );
+            static void destroy_layout( void * );
+            void help_resize();
+            void grow( Layout * );
+            bool start_resize( Layout *, size_type );
+            void transfer( Layout * );
+            void move_bucket( Layout &, Layout &, size_type );
+            Layout * finish_resize();
+
+        private:
+            std::atomic< Layout * > m_layout;              //!< Layout atual; o seguinte, se houver, recebe os buckets.
+            std::array< Counter, STRIPES > m_counts;       //!< Contagens por faixa do hash, independentes do layout.
+            GrowthPolicy m_growth;  //!< Lida sob a trava de um bucket vivo, alterada com todas as do layout atual.
+            node_allocator m_alloc; //!< Alocador dos nós, compartilhado por todas as listas.
+
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "concurrent_hashtbl.inl"
+#endif
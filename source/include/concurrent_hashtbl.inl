@@ -0,0 +1,532 @@
+#include "concurrent_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::Layout::Layout(size_type size_)
+        : size{size_}, buckets{nullptr}, stripes{new Stripe[STRIPES]}, moved{new std::atomic<bool>[size_]}
+    {
+        index.reset(size_);
+        for (size_type i = 0; i < size_; ++i)
+        {
+            moved[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::ConcurrentHashTbl(size_type sz, const GrowthPolicy &growth, const Allocator &alloc)
+        : m_growth{growth}, m_alloc{alloc}
+    {
+        m_layout.store(new_layout(IndexPolicy::bucket_count(sz)), std::memory_order_release);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::~ConcurrentHashTbl()
+    {
+        // Os layouts esvaziados já foram aposentados; um resize interrompido deixa nós nos dois
+        // últimos, e ambos liberam os seus
+        for (Layout *layout = m_layout.load(std::memory_order_relaxed); layout != nullptr;)
+        {
+            Layout *next = layout->next.load(std::memory_order_relaxed);
+            delete[] layout->buckets;
+            delete layout;
+            layout = next;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        return insert_impl(key_, new_data_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename M>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_or_assign(const KeyType &key_, M &&obj_)
+    {
+        return insert_impl(key_, std::forward<M>(obj_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin; // Nenhum layout lido daqui em diante é liberado antes do fim da operação
+
+        return locked_bucket<shared_lock>(hash, [&](list_type &guarda, Layout &)
+        {
+            for (const auto &entry : guarda)
+            {
+                if (matches(entry, key_, hash))
+                {
+                    data_item_ = entry.m_data; // Copia o dado ainda sob a trava
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::contains(const KeyType &key_) const
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+
+        return locked_bucket<shared_lock>(hash, [&](list_type &guarda, Layout &)
+        {
+            return std::any_of(guarda.begin(), guarda.end(), [&](const node_type &entry)
+                               { return matches(entry, key_, hash); });
+        });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::erase(const KeyType &key_)
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+        help_resize();
+
+        return locked_bucket<exclusive_lock>(hash, [&](list_type &guarda, Layout &)
+        {
+            for (auto prev = guarda.before_begin(), curr = guarda.begin(); curr != guarda.end(); ++prev, ++curr)
+            {
+                if (matches(*curr, key_, hash))
+                {
+                    guarda.erase_after(prev);
+                    m_counts[counter_of(hash)].value.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Fn>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::update(const KeyType &key_, Fn &&fn_)
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+        help_resize();
+
+        return locked_bucket<exclusive_lock>(hash, [&](list_type &guarda, Layout &)
+        {
+            for (auto &entry : guarda)
+            {
+                if (matches(entry, key_, hash))
+                {
+                    fn_(entry.m_data);
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::clear()
+    {
+        EpochGuard pin;
+        for (;;)
+        {
+            Layout *layout = finish_resize();
+            AllStripes all(*layout);
+
+            // Um resize pode ter começado antes de todas as travas: termina-o primeiro
+            if (layout->next.load(std::memory_order_acquire) == nullptr)
+            {
+                for (size_type i = 0; i < layout->size; ++i)
+                {
+                    layout->buckets[i].clear();
+                }
+                for (auto &counter : m_counts)
+                {
+                    counter.value.store(0, std::memory_order_relaxed);
+                }
+                return;
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size() const
+    {
+        size_type total = 0;
+        for (const auto &counter : m_counts)
+        {
+            total += counter.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_count() const
+    {
+        EpochGuard pin;
+        return m_layout.load(std::memory_order_acquire)->size;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    float ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::max_load_factor() const
+    {
+        EpochGuard pin;
+        return read_growth([](const GrowthPolicy &growth, const Layout &)
+                           { return growth.max_load_factor(); });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::max_load_factor(float mlf)
+    {
+        EpochGuard pin;
+        for (;;)
+        {
+            Layout *layout = finish_resize();
+            size_type target = 0;
+            {
+                AllStripes all(*layout);
+                if (layout->next.load(std::memory_order_acquire) != nullptr)
+                {
+                    continue;
+                }
+                m_growth.max_load_factor(mlf);
+                target = m_growth.grow_to(size(), layout->size);
+            }
+
+            // O resize precisa das travas que acabaram de ser liberadas
+            if (target != 0 && start_resize(layout, target))
+            {
+                transfer(layout);
+                finish_resize();
+            }
+            return;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    float ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::load_factor() const
+    {
+        return static_cast<float>(size()) / bucket_count();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::reserve(size_type n_)
+    {
+        EpochGuard pin;
+        for (;;)
+        {
+            Layout *layout = finish_resize();
+            const size_type needed = read_growth([n_](const GrowthPolicy &growth, const Layout &)
+                                                 { return growth.buckets_for(n_); });
+            if (needed <= layout->size)
+            {
+                return;
+            }
+            if (start_resize(layout, needed))
+            {
+                transfer(layout);
+                finish_resize();
+                return;
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::rehash(size_type n_)
+    {
+        EpochGuard pin;
+        for (;;)
+        {
+            Layout *layout = finish_resize();
+            const size_type target = read_growth([this, n_](const GrowthPolicy &growth, const Layout &)
+                                                 { return std::max(n_, growth.buckets_for(size())); });
+            if (IndexPolicy::bucket_count(target) == layout->size)
+            {
+                return;
+            }
+            if (start_resize(layout, target))
+            {
+                transfer(layout);
+                finish_resize();
+                return;
+            }
+        }
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::hash_of(const node_type &entry)
+    {
+        if constexpr (store_hash<KeyType>::value)
+            return entry.m_hash;
+        else
+            return KeyHash()(entry.m_key);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::matches(const node_type &entry, const KeyType &key_, size_type hash)
+    {
+        if constexpr (store_hash<KeyType>::value)
+            return entry.m_hash == hash && KeyEqual()(entry.m_key, key_);
+        else
+            return KeyEqual()(entry.m_key, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::stripe_of(size_type index_, size_type buckets_)
+    {
+        // Faixas contíguas: a trava s cobre os buckets [s * n / STRIPES, (s + 1) * n / STRIPES)
+        return index_ * STRIPES / buckets_;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::counter_of(size_type hash)
+    {
+        // O contador depende só do hash: um nó movido de layout não muda de contador
+        return static_cast<size_type>(detail::mix_hash(hash) % STRIPES);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Lock, typename Fn>
+    decltype(auto) ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::locked_bucket(size_type hash, Fn &&fn_) const
+    {
+        Layout *layout = m_layout.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const size_type index = layout->index.index(hash);
+            Lock guard(layout->stripes[stripe_of(index, layout->size)].lock);
+
+            // Com a trava, o bucket não pode ser movido; se já foi, o marcador aponta o destino
+            if (!layout->moved[index].load(std::memory_order_relaxed))
+            {
+                return fn_(layout->buckets[index], *layout);
+            }
+            layout = layout->next.load(std::memory_order_acquire);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Fn>
+    decltype(auto) ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::read_growth(Fn &&fn_) const
+    {
+        // A política só muda com todas as travas de um layout atual e sem resize; segurar uma
+        // delas com o layout ainda atual basta, pois o resize seguinte não terminaria sem ela
+        for (;;)
+        {
+            Layout *layout = m_layout.load(std::memory_order_acquire);
+            shared_lock guard(layout->stripes[0].lock);
+            if (layout == m_layout.load(std::memory_order_acquire))
+            {
+                return fn_(m_growth, *layout);
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename M>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_impl(const KeyType &key_, M &&data_)
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+        help_resize();
+
+        Layout *used = nullptr;
+        bool crowded = false;
+        const bool inserted = locked_bucket<exclusive_lock>(hash, [&](list_type &guarda, Layout &layout)
+        {
+            for (auto &entry : guarda)
+            {
+                if (matches(entry, key_, hash))
+                {
+                    entry.m_data = std::forward<M>(data_); // A chave já existe: apenas atualiza o dado
+                    return false;
+                }
+            }
+
+            if constexpr (store_hash<KeyType>::value)
+                guarda.emplace_front(hash, std::piecewise_construct, std::forward_as_tuple(key_),
+                                     std::forward_as_tuple(std::forward<M>(data_)));
+            else
+                guarda.emplace_front(std::piecewise_construct, std::forward_as_tuple(key_),
+                                     std::forward_as_tuple(std::forward<M>(data_)));
+            const size_type count = m_counts[counter_of(hash)].value.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            // Estima o total por um contador; só então vale a pena somar todos
+            crowded = m_growth.grow_to(count * STRIPES, layout.size) != 0;
+            used = &layout;
+            return true;
+        });
+
+        if (crowded)
+        {
+            grow(used);
+        }
+        return inserted;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::Layout *
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::new_layout(size_type size_)
+    {
+        Layout *layout = new Layout(size_);
+        layout->buckets = new list_type[size_];
+
+        if constexpr (!std::allocator_traits<node_allocator>::is_always_equal::value)
+        {
+            for (size_type i = 0; i < size_; ++i)
+            {
+                layout->buckets[i] = list_type(m_alloc);
+            }
+        }
+        return layout;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::destroy_layout(void *layout_)
+    {
+        delete static_cast<Layout *>(layout_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::help_resize()
+    {
+        // Todo escritor que encontra um resize em andamento move uma parte dele
+        Layout *layout = m_layout.load(std::memory_order_acquire);
+        if (layout->next.load(std::memory_order_acquire) != nullptr)
+        {
+            transfer(layout);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::grow(Layout *layout_)
+    {
+        // Só o layout atual cresce, e só uma vez: um layout em esvaziamento já tem destino
+        if (layout_ != m_layout.load(std::memory_order_acquire) || layout_->next.load(std::memory_order_acquire) != nullptr)
+        {
+            return;
+        }
+        const size_type target = read_growth([this](const GrowthPolicy &growth, const Layout &layout)
+                                             { return growth.grow_to(size(), layout.size); });
+        if (target != 0 && start_resize(layout_, target))
+        {
+            transfer(layout_);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::start_resize(Layout *layout_, size_type buckets_)
+    {
+        const size_type new_size = IndexPolicy::bucket_count(buckets_);
+        if (new_size == layout_->size)
+        {
+            return false;
+        }
+
+        // Só uma thread publica o destino; as demais descartam o seu
+        Layout *fresh = new_layout(new_size);
+        Layout *expected = nullptr;
+        if (!layout_->next.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            delete[] fresh->buckets;
+            delete fresh;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::transfer(Layout *layout_)
+    {
+        Layout *next = layout_->next.load(std::memory_order_acquire);
+
+        // Reivindica faixas de buckets antigos até não sobrar nenhuma
+        for (;;)
+        {
+            const size_type first = layout_->claimed.fetch_add(TRANSFER_STRIDE, std::memory_order_relaxed);
+            if (first >= layout_->size)
+            {
+                return;
+            }
+            const size_type last = std::min(first + TRANSFER_STRIDE, layout_->size);
+            for (size_type i = first; i < last; ++i)
+            {
+                move_bucket(*layout_, *next, i);
+            }
+
+            // Quem move o último bucket publica o destino e libera as listas antigas, já vazias. O
+            // resto do layout é aposentado: outra thread pode ainda segurar uma de suas travas
+            if (layout_->transferred.fetch_add(last - first, std::memory_order_acq_rel) + (last - first) == layout_->size)
+            {
+                delete[] layout_->buckets;
+                layout_->buckets = nullptr;
+                m_layout.store(next, std::memory_order_release);
+                EpochDomain::global().retire(layout_, &destroy_layout);
+                return;
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::move_bucket(Layout &from_, Layout &to_, size_type index_)
+    {
+        // Sempre a trava do layout antigo antes das do novo, e só uma do novo por vez
+        exclusive_lock guard(from_.stripes[stripe_of(index_, from_.size)].lock);
+        list_type &origem = from_.buckets[index_];
+
+        // Religa os nós nas listas novas, sem alocar nem copiar entradas
+        Stripe *held = nullptr;
+        exclusive_lock target;
+        while (!origem.empty())
+        {
+            const size_type index = to_.index.index(hash_of(origem.front()));
+            Stripe &stripe = to_.stripes[stripe_of(index, to_.size)];
+            if (&stripe != held)
+            {
+                // Solta a trava anterior antes de pegar a próxima: duas do novo layout, em
+                // qualquer ordem, poderiam travar contra outra thread
+                if (target.owns_lock())
+                {
+                    target.unlock();
+                }
+                target = exclusive_lock(stripe.lock);
+                held = &stripe;
+            }
+            list_type &destino = to_.buckets[index];
+            destino.splice_after(destino.before_begin(), origem, origem.before_begin());
+        }
+        from_.moved[index_].store(true, std::memory_order_relaxed);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::Layout *
+    ConcurrentHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::finish_resize()
+    {
+        // Ajuda até o layout atual não ter destino; faixas de outras threads são esperadas
+        for (;;)
+        {
+            Layout *layout = m_layout.load(std::memory_order_acquire);
+            if (layout->next.load(std::memory_order_acquire) == nullptr)
+            {
+                return layout;
+            }
+            transfer(layout);
+            if (layout == m_layout.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+} // Namespace ac.
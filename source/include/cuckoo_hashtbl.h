@@ -0,0 +1,120 @@
+#ifndef CUCKOO_HASHTBL_H
+#define CUCKOO_HASHTBL_H
+
+#include <cstdint>      // uint8_t
+#include <cstring>      // memset, memcpy
+#include <algorithm>    // std::min, std::max
+#include <functional>   // std::hash, std::equal_to
+#include <iostream>     // ostream
+#include <initializer_list>
+#include <memory>       // std::allocator
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <utility>      // std::swap, std::move
+#include <vector>       // stash, BFS queue
+
+#include "hashtbl.h"    // HashEntry
+#include "hash_utils.h" // mix_hash
+
+namespace ac // Associative container
+{
+    /// Bucketized cuckoo hash table: every key may live in one of two buckets of 4 slots.
+    /// A lookup therefore inspects at most two buckets (plus a tiny stash), no matter the load.
+    /// Inserts that find both buckets full search, breadth-first, for the shortest chain of
+    /// relocations that frees a slot; if none exists the entry goes to the stash. The stash
+    /// never holds more than STASH_SIZE entries: when it is full the table grows if it is at
+    /// least half loaded, and otherwise rehashes in place with a new hash seed. Keys that no
+    /// seed can separate (their KeyHash values are equal) throw std::length_error after
+    /// MAX_REHASHES seeds, leaving the table unchanged.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class CuckooHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using size_type  = std::size_t;
+
+            explicit CuckooHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            CuckooHashTbl( const CuckooHashTbl& );
+            CuckooHashTbl( const std::initializer_list< entry_type > & );
+            CuckooHashTbl& operator=( const CuckooHashTbl& );
+            CuckooHashTbl& operator=( const std::initializer_list< entry_type > & );
+
+            virtual ~CuckooHashTbl();
+
+            bool insert( const KeyType &, const DataType &  );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool erase( const KeyType & );
+            void clear();
+            bool empty() const;
+            inline size_type size() const { return m_count; };
+            DataType& at( const KeyType& );
+            DataType& operator[]( const KeyType& );
+            size_type count( const KeyType& ) const;
+            float max_load_factor() const;
+            void max_load_factor(float mlf);
+
+            friend std::ostream & operator<<( std::ostream & os_, const CuckooHashTbl & ht_ ) {
+                for (size_type i = 0; i < ht_.m_buckets * SLOTS; ++i) {
+                    if ( ht_.m_tags[i] != 0 ) {
+                        os_ << "{" << ht_.m_slots[i].m_key << "," << ht_.m_slots[i].m_data << "} ";
+                    }
+                }
+                for (const auto& entry : ht_.m_stash) {
+                    os_ << "{" << entry.m_key << "," << entry.m_data << "} ";
+                }
+                return os_;
+            }
+
+        private:
+            static constexpr size_type SLOTS = 4;       //!< Slots per bucket.
+            static constexpr size_type STASH_SIZE = 4;  //!< Entries the stash holds at most.
+            static constexpr size_type MAX_REHASHES = 4; //!< New seeds tried for one insert before giving up.
+            static constexpr size_type MAX_BFS = 256;   //!< Buckets a single eviction search may visit.
+
+            /// Where a key may live: two candidate buckets and the 8-bit tag stored for it.
+            struct Probe {
+                size_type b1;
+                size_type b2;
+                std::uint8_t tag;
+            };
+
+            /// Node of the eviction search tree: the entry in `slot` of the parent's bucket may move here.
+            struct PathNode {
+                size_type bucket;
+                int parent;
+                int slot;
+            };
+
+            Probe probe_of( const KeyType & ) const;
+            size_type alt_bucket( size_type, std::uint8_t ) const;
+            entry_type * find_entry( const KeyType & ) const;
+            size_type free_slot( size_type ) const;
+            entry_type * place( size_type, std::uint8_t, entry_type && );
+            entry_type * try_place( entry_type & );
+            entry_type * insert_new( entry_type && );
+            bool make_room( const Probe &, size_type & );
+            void drain_stash();
+            size_type max_elements( size_type ) const;
+            size_type buckets_for( size_type ) const;
+            void allocate( size_type );
+            void release();
+            void take_entries( std::vector< entry_type > & );
+            void resize( size_type );
+            void swap( CuckooHashTbl & );
+
+        private:
+            size_type m_buckets;             //!< Number of buckets; always a power of two.
+            size_type m_count;               //!< Number of elements in the table (stash included).
+            float m_max_load_factor;         //!< Ratio of full slots that triggers growth.
+            std::uint64_t m_seed;            //!< Mixed into every hash; a rehash in place draws a new one.
+            std::uint8_t *m_tags;            //!< Per slot: 0 if empty, else an 8-bit tag of the key's hash.
+            entry_type *m_slots;             //!< Raw slot storage, SLOTS consecutive slots per bucket.
+            std::vector< entry_type > m_stash; //!< Overflow for entries no eviction path could place.
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "cuckoo_hashtbl.inl"
+#endif
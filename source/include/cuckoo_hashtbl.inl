@@ -0,0 +1,514 @@
+#include "cuckoo_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::CuckooHashTbl(size_type sz)
+        : m_buckets{0}, m_count{0}, m_max_load_factor{0.9f}, m_seed{0}, m_tags{nullptr}, m_slots{nullptr}
+    {
+        allocate(buckets_for(sz));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::CuckooHashTbl(const CuckooHashTbl &source)
+        : m_buckets{0}, m_count{0}, m_max_load_factor{source.m_max_load_factor}, m_seed{source.m_seed}, m_tags{nullptr}, m_slots{nullptr}
+    {
+        allocate(source.m_buckets);
+
+        // Mesma geometria: cada entrada é copiada para o mesmo slot
+        std::memcpy(m_tags, source.m_tags, m_buckets * SLOTS);
+        for (size_type i = 0; i < m_buckets * SLOTS; ++i)
+        {
+            if (m_tags[i] != 0)
+            {
+                ::new (static_cast<void *>(m_slots + i)) entry_type(source.m_slots[i]);
+            }
+        }
+        m_stash = source.m_stash;
+        m_stash.reserve(STASH_SIZE);
+        m_count = source.m_count;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::CuckooHashTbl(const std::initializer_list<entry_type> &ilist)
+        : CuckooHashTbl(ilist.size())
+    {
+        for (const auto &entry : ilist)
+        {
+            insert(entry.m_key, entry.m_data);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const CuckooHashTbl &clone)
+    {
+        if (this == &clone)
+            return *this;
+
+        CuckooHashTbl copy(clone);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const std::initializer_list<entry_type> &ilist)
+    {
+        CuckooHashTbl copy(ilist);
+        copy.max_load_factor(m_max_load_factor);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::~CuckooHashTbl()
+    {
+        release();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        entry_type *entry = find_entry(key_);
+
+        if (entry != nullptr)
+        {
+            entry->m_data = new_data_; // A chave já existe: apenas atualiza o dado
+            return false;
+        }
+
+        insert_new(entry_type(key_, new_data_));
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const entry_type *entry = find_entry(key_);
+
+        if (entry != nullptr)
+        {
+            data_item_ = entry->m_data; // Armazena o dado encontrado na variável de saída
+            return true;
+        }
+
+        return false; // A chave não foi encontrada
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        entry_type *entry = find_entry(key_);
+
+        if (entry == nullptr)
+            return false;
+
+        --m_count;
+        if (entry >= m_slots && entry < m_slots + m_buckets * SLOTS)
+        {
+            entry->~entry_type();
+            m_tags[entry - m_slots] = 0;
+            drain_stash(); // O slot liberado pode acomodar uma entrada do stash
+        }
+        else
+        {
+            std::swap(*entry, m_stash.back());
+            m_stash.pop_back();
+        }
+
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        for (size_type i = 0; i < m_buckets * SLOTS; ++i)
+        {
+            if (m_tags[i] != 0)
+            {
+                m_slots[i].~entry_type();
+            }
+        }
+        std::memset(m_tags, 0, m_buckets * SLOTS);
+        m_stash.clear();
+        m_count = 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::empty() const
+    {
+        return m_count == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        entry_type *entry = find_entry(key_);
+
+        if (entry != nullptr)
+        {
+            return entry->m_data;
+        }
+
+        throw std::out_of_range("Key not found in CuckooHashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        entry_type *entry = find_entry(key_);
+
+        if (entry == nullptr)
+        {
+            // Insere uma nova entrada com a chave e um valor padrão para o dado
+            entry = insert_new(entry_type(key_, DataType()));
+        }
+
+        return entry->m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    {
+        return find_entry(key_) != nullptr ? 1 : 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    float CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor(float mlf)
+    {
+        m_max_load_factor = std::min(std::max(mlf, 0.125f), 0.98f);
+        resize(buckets_for(m_count));
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Probe
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::probe_of(const KeyType &key_) const
+    {
+        const auto hash = detail::mix_hash(KeyHash()(key_) ^ m_seed);
+        auto tag = static_cast<std::uint8_t>(hash >> 56);
+        if (tag == 0)
+            tag = 1; // Zero marca slot vazio
+
+        const size_type b1 = static_cast<size_type>(hash) & (m_buckets - 1);
+        return Probe{b1, alt_bucket(b1, tag), tag};
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::alt_bucket(size_type bucket_, std::uint8_t tag_) const
+    {
+        // Cuckoo de chave parcial: o bucket alternativo sai do bucket atual e da tag, sem
+        // recalcular o hash da chave; aplicar duas vezes devolve o bucket original.
+        return (bucket_ ^ (tag_ * size_type{0x5bd1e995})) & (m_buckets - 1);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_entry(const KeyType &key_) const
+    {
+        const Probe p = probe_of(key_);
+
+        for (const size_type bucket : {p.b1, p.b2})
+        {
+            for (size_type i = bucket * SLOTS; i < (bucket + 1) * SLOTS; ++i)
+            {
+                if (m_tags[i] == p.tag && KeyEqual()(m_slots[i].m_key, key_))
+                {
+                    return m_slots + i;
+                }
+            }
+        }
+
+        for (const auto &entry : m_stash)
+        {
+            if (KeyEqual()(entry.m_key, key_))
+            {
+                return const_cast<entry_type *>(&entry);
+            }
+        }
+
+        return nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::free_slot(size_type bucket_) const
+    {
+        for (size_type i = bucket_ * SLOTS; i < (bucket_ + 1) * SLOTS; ++i)
+        {
+            if (m_tags[i] == 0)
+            {
+                return i;
+            }
+        }
+        return m_buckets * SLOTS; // Bucket cheio
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::place(size_type slot_, std::uint8_t tag_, entry_type &&entry_)
+    {
+        ::new (static_cast<void *>(m_slots + slot_)) entry_type(std::move(entry_));
+        m_tags[slot_] = tag_;
+        return m_slots + slot_;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::try_place(entry_type &entry_)
+    {
+        const Probe p = probe_of(entry_.m_key);
+        size_type slot;
+
+        if (make_room(p, slot))
+        {
+            ++m_count;
+            return place(slot, p.tag, std::move(entry_));
+        }
+        if (m_stash.size() < STASH_SIZE)
+        {
+            ++m_count;
+            m_stash.push_back(std::move(entry_));
+            return &m_stash.back();
+        }
+        return nullptr; // Sem caminho de despejo e stash cheio; `entry_` fica intacta
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert_new(entry_type &&entry_)
+    {
+        if (m_count + 1 > max_elements(m_buckets))
+        {
+            resize(m_buckets * 2);
+        }
+
+        size_type seeds = 0;
+        for (;;)
+        {
+            if (entry_type *placed = try_place(entry_))
+            {
+                return placed;
+            }
+
+            if (m_count >= max_elements(m_buckets) / 2)
+            {
+                resize(m_buckets * 2);
+            }
+            else if (seeds++ < MAX_REHASHES)
+            {
+                // Com a tabela pouco cheia, crescer não resolveria colisões: troca-se a semente.
+                m_seed = detail::mix_hash(m_seed + 0x9e3779b97f4a7c15ULL);
+                resize(m_buckets);
+            }
+            else
+            {
+                throw std::length_error("CuckooHashTbl: keys collide under every hash seed");
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::make_room(const Probe &probe_, size_type &slot_)
+    {
+        // Busca em largura pelo caminho de despejos mais curto até um bucket com slot livre.
+        PathNode nodes[MAX_BFS];
+        size_type n_nodes = 0;
+        nodes[n_nodes++] = PathNode{probe_.b1, -1, -1};
+        nodes[n_nodes++] = PathNode{probe_.b2, -1, -1};
+
+        for (size_type head = 0; head < n_nodes; ++head)
+        {
+            const size_type free = free_slot(nodes[head].bucket);
+
+            if (free != m_buckets * SLOTS)
+            {
+                // Percorre o caminho de volta: cada entrada vai para o slot liberado pela anterior.
+                size_type hole = free;
+                for (int child = static_cast<int>(head); nodes[child].parent >= 0; child = nodes[child].parent)
+                {
+                    const size_type from = nodes[nodes[child].parent].bucket * SLOTS + nodes[child].slot;
+                    place(hole, m_tags[from], std::move(m_slots[from]));
+                    m_slots[from].~entry_type();
+                    m_tags[from] = 0;
+                    hole = from;
+                }
+                slot_ = hole;
+                return true;
+            }
+
+            for (size_type s = 0; s < SLOTS && n_nodes < MAX_BFS; ++s)
+            {
+                const size_type bucket = nodes[head].bucket;
+                const size_type next = alt_bucket(bucket, m_tags[bucket * SLOTS + s]);
+
+                // Um bucket não pode aparecer duas vezes no mesmo caminho.
+                bool on_path = false;
+                for (int node = static_cast<int>(head); node >= 0 && !on_path; node = nodes[node].parent)
+                {
+                    on_path = nodes[node].bucket == next;
+                }
+                if (!on_path)
+                {
+                    nodes[n_nodes++] = PathNode{next, static_cast<int>(head), static_cast<int>(s)};
+                }
+            }
+        }
+
+        return false;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::drain_stash()
+    {
+        for (size_type i = m_stash.size(); i-- > 0;)
+        {
+            const Probe p = probe_of(m_stash[i].m_key);
+            size_type slot = free_slot(p.b1);
+            if (slot == m_buckets * SLOTS)
+                slot = free_slot(p.b2);
+
+            if (slot != m_buckets * SLOTS)
+            {
+                place(slot, p.tag, std::move(m_stash[i]));
+                std::swap(m_stash[i], m_stash.back());
+                m_stash.pop_back();
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_elements(size_type buckets_) const
+    {
+        return static_cast<size_type>(buckets_ * SLOTS * m_max_load_factor);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::buckets_for(size_type n_) const
+    {
+        size_type buckets = 2;
+        while (max_elements(buckets) < n_)
+        {
+            buckets *= 2;
+        }
+        return buckets;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::allocate(size_type buckets_)
+    {
+        m_slots = std::allocator<entry_type>().allocate(buckets_ * SLOTS);
+        m_tags = new std::uint8_t[buckets_ * SLOTS];
+        std::memset(m_tags, 0, buckets_ * SLOTS);
+        m_buckets = buckets_;
+        m_count = 0;
+        m_stash.clear();
+        m_stash.reserve(STASH_SIZE);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::release()
+    {
+        if (m_tags == nullptr)
+            return;
+
+        clear();
+        std::allocator<entry_type>().deallocate(m_slots, m_buckets * SLOTS);
+        delete[] m_tags;
+        m_tags = nullptr;
+        m_slots = nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::take_entries(std::vector<entry_type> &entries_)
+    {
+        for (size_type i = 0; i < m_buckets * SLOTS; ++i)
+        {
+            if (m_tags[i] != 0)
+            {
+                entries_.push_back(std::move(m_slots[i]));
+            }
+        }
+        for (auto &entry : m_stash)
+        {
+            entries_.push_back(std::move(entry));
+        }
+        release();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::resize(size_type new_buckets_)
+    {
+        std::uint8_t *old_tags = m_tags;
+        entry_type *old_slots = m_slots;
+        const size_type old_buckets = m_buckets;
+        std::vector<entry_type> old_stash;
+        old_stash.swap(m_stash);
+
+        allocate(new_buckets_);
+
+        // Entradas que não couberam; só é usado se a redistribuição falhar.
+        std::vector<entry_type> pending;
+        for (size_type i = 0; i < old_buckets * SLOTS; ++i)
+        {
+            if (old_tags[i] != 0)
+            {
+                if (try_place(old_slots[i]) == nullptr)
+                    pending.push_back(std::move(old_slots[i]));
+                old_slots[i].~entry_type();
+            }
+        }
+        for (auto &entry : old_stash)
+        {
+            if (try_place(entry) == nullptr)
+                pending.push_back(std::move(entry));
+        }
+
+        std::allocator<entry_type>().deallocate(old_slots, old_buckets * SLOTS);
+        delete[] old_tags;
+
+        // Sem recursão: recomeça com outra semente e, após MAX_REHASHES delas, com o dobro de buckets.
+        for (size_type seeds = 1; !pending.empty(); ++seeds)
+        {
+            take_entries(pending);
+            if (seeds % MAX_REHASHES == 0)
+                new_buckets_ *= 2;
+            m_seed = detail::mix_hash(m_seed + 0x9e3779b97f4a7c15ULL);
+            allocate(new_buckets_);
+
+            std::vector<entry_type> retry;
+            retry.swap(pending);
+            for (auto &entry : retry)
+            {
+                if (try_place(entry) == nullptr)
+                    pending.push_back(std::move(entry));
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void CuckooHashTbl<KeyType, DataType, KeyHash, KeyEqual>::swap(CuckooHashTbl &other)
+    {
+        std::swap(m_buckets, other.m_buckets);
+        std::swap(m_count, other.m_count);
+        std::swap(m_max_load_factor, other.m_max_load_factor);
+        std::swap(m_seed, other.m_seed);
+        std::swap(m_tags, other.m_tags);
+        std::swap(m_slots, other.m_slots);
+        m_stash.swap(other.m_stash);
+    }
+} // Namespace ac.
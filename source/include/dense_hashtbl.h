@@ -0,0 +1,90 @@
+#ifndef DENSE_HASHTBL_H
+#define DENSE_HASHTBL_H
+
+#include <cstdint>      // uint32_t
+#include <algorithm>    // std::min, std::max
+#include <functional>   // std::hash, std::equal_to
+#include <iostream>     // ostream
+#include <initializer_list>
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <utility>      // std::move
+#include <vector>       // entries and bucket heads
+
+#include "hashtbl.h"    // HashEntry
+#include "hash_utils.h" // mix_hash
+
+namespace ac // Associative container
+{
+    /// Chained hash table with a dense layout: entries live contiguously in a vector, in
+    /// insertion order, and buckets and chains link them through 32-bit indices instead of
+    /// pointers. Printing or scanning the table streams one array, never visiting empty
+    /// buckets. erase() moves the last entry into the hole to keep the array dense, so
+    /// iteration order is insertion order up to those moves.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class DenseHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using size_type  = std::size_t;
+
+            explicit DenseHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            DenseHashTbl( const DenseHashTbl& ) = default;
+            DenseHashTbl( const std::initializer_list< entry_type > & );
+            DenseHashTbl& operator=( const DenseHashTbl& ) = default;
+            DenseHashTbl& operator=( const std::initializer_list< entry_type > & );
+
+            virtual ~DenseHashTbl() = default;
+
+            bool insert( const KeyType &, const DataType &  );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool erase( const KeyType & );
+            void clear();
+            bool empty() const;
+            inline size_type size() const { return m_entries.size(); };
+            DataType& at( const KeyType& );
+            DataType& operator[]( const KeyType& );
+            size_type count( const KeyType& ) const;
+            float max_load_factor() const;
+            void max_load_factor(float mlf);
+            inline size_type bucket_count() const { return m_buckets.size(); }
+            void reserve( size_type n_ );
+
+            friend std::ostream & operator<<( std::ostream & os_, const DenseHashTbl & ht_ ) {
+                for (const auto& slot : ht_.m_entries) {
+                    os_ << "{" << slot.entry.m_key << "," << slot.entry.m_data << "} ";
+                }
+                return os_;
+            }
+
+        private:
+            //! End of a chain (and an empty bucket).
+            static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+
+            /// An entry plus what the chains need: its hash and the index of the next entry.
+            struct Slot {
+                entry_type entry;
+                std::uint32_t hash;
+                std::uint32_t next;
+            };
+
+            static std::uint32_t hash_of( const KeyType & );
+            std::uint32_t find_index( const KeyType &, std::uint32_t ) const;
+            std::uint32_t insert_new( entry_type &&, std::uint32_t );
+            std::uint32_t * link_to( std::uint32_t );
+            size_type max_elements( size_type ) const;
+            size_type buckets_for( size_type ) const;
+            void resize( size_type );
+
+        private:
+            std::vector< Slot > m_entries;          //!< Entries, densely packed in insertion order.
+            std::vector< std::uint32_t > m_buckets; //!< Head of each chain; size is a power of two.
+            float m_max_load_factor{1.0f};          //!< Average chain length that triggers growth.
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "dense_hashtbl.inl"
+#endif
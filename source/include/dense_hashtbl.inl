@@ -0,0 +1,250 @@
+#include "dense_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::DenseHashTbl(size_type sz)
+    {
+        resize(buckets_for(sz));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::DenseHashTbl(const std::initializer_list<entry_type> &ilist)
+        : DenseHashTbl(ilist.size())
+    {
+        for (const auto &entry : ilist)
+        {
+            insert(entry.m_key, entry.m_data);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const std::initializer_list<entry_type> &ilist)
+    {
+        clear();
+        reserve(ilist.size());
+        for (const auto &entry : ilist)
+        {
+            insert(entry.m_key, entry.m_data);
+        }
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        const std::uint32_t hash = hash_of(key_);
+        const std::uint32_t i = find_index(key_, hash);
+
+        if (i != NIL)
+        {
+            m_entries[i].entry.m_data = new_data_; // A chave já existe: apenas atualiza o dado
+            return false;
+        }
+
+        insert_new(entry_type(key_, new_data_), hash);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const std::uint32_t i = find_index(key_, hash_of(key_));
+
+        if (i != NIL)
+        {
+            data_item_ = m_entries[i].entry.m_data; // Armazena o dado encontrado na variável de saída
+            return true;
+        }
+
+        return false; // A chave não foi encontrada
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        const std::uint32_t i = find_index(key_, hash_of(key_));
+
+        if (i == NIL)
+            return false;
+
+        // Tira a entrada da sua lista
+        std::uint32_t *link = link_to(i);
+        *link = m_entries[i].next;
+
+        // A última entrada ocupa o buraco, e quem apontava para ela passa a apontar para i
+        const auto last = static_cast<std::uint32_t>(m_entries.size() - 1);
+        if (i != last)
+        {
+            *link_to(last) = i;
+            m_entries[i] = std::move(m_entries[last]);
+        }
+        m_entries.pop_back();
+
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        m_entries.clear();
+        std::fill(m_buckets.begin(), m_buckets.end(), NIL);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::empty() const
+    {
+        return m_entries.empty();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        const std::uint32_t i = find_index(key_, hash_of(key_));
+
+        if (i != NIL)
+        {
+            return m_entries[i].entry.m_data;
+        }
+
+        throw std::out_of_range("Key not found in DenseHashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        const std::uint32_t hash = hash_of(key_);
+        std::uint32_t i = find_index(key_, hash);
+
+        if (i == NIL)
+        {
+            // Insere uma nova entrada com a chave e um valor padrão para o dado
+            i = insert_new(entry_type(key_, DataType()), hash);
+        }
+
+        return m_entries[i].entry.m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    {
+        return find_index(key_, hash_of(key_)) != NIL ? 1 : 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    float DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor(float mlf)
+    {
+        m_max_load_factor = std::min(std::max(mlf, 0.125f), 8.0f);
+        resize(buckets_for(m_entries.size()));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::reserve(size_type n_)
+    {
+        m_entries.reserve(n_);
+        if (buckets_for(n_) > m_buckets.size())
+        {
+            resize(buckets_for(n_));
+        }
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint32_t DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::hash_of(const KeyType &key_)
+    {
+        // 32 bits bastam: os índices dos buckets também são de 32 bits
+        return static_cast<std::uint32_t>(detail::mix_hash(KeyHash()(key_)));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint32_t DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_index(const KeyType &key_, std::uint32_t hash_) const
+    {
+        const size_type mask = m_buckets.size() - 1;
+
+        for (std::uint32_t i = m_buckets[hash_ & mask]; i != NIL; i = m_entries[i].next)
+        {
+            if (m_entries[i].hash == hash_ && KeyEqual()(m_entries[i].entry.m_key, key_))
+            {
+                return i;
+            }
+        }
+
+        return NIL;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint32_t DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert_new(entry_type &&entry_, std::uint32_t hash_)
+    {
+        if (m_entries.size() >= NIL)
+        {
+            throw std::length_error("DenseHashTbl holds at most 2^32 - 1 entries");
+        }
+        if (m_entries.size() + 1 > max_elements(m_buckets.size()))
+        {
+            resize(m_buckets.size() * 2);
+        }
+
+        // Nova entrada no fim do vetor, na cabeça da lista do seu bucket
+        const auto i = static_cast<std::uint32_t>(m_entries.size());
+        std::uint32_t &head = m_buckets[hash_ & (m_buckets.size() - 1)];
+        m_entries.push_back(Slot{std::move(entry_), hash_, head});
+        head = i;
+
+        return i;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint32_t *DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::link_to(std::uint32_t i_)
+    {
+        // O elo que aponta para i_: a cabeça do bucket ou o `next` da entrada anterior
+        std::uint32_t *link = &m_buckets[m_entries[i_].hash & (m_buckets.size() - 1)];
+        while (*link != i_)
+        {
+            link = &m_entries[*link].next;
+        }
+        return link;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_elements(size_type buckets_) const
+    {
+        return static_cast<size_type>(buckets_ * m_max_load_factor);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::buckets_for(size_type n_) const
+    {
+        size_type buckets = 8;
+        while (max_elements(buckets) < n_)
+        {
+            buckets *= 2;
+        }
+        return buckets;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DenseHashTbl<KeyType, DataType, KeyHash, KeyEqual>::resize(size_type buckets_)
+    {
+        // Rehash sem tocar nas entradas: só refaz as listas, percorrendo o vetor em ordem
+        m_buckets.assign(buckets_, NIL);
+        const size_type mask = buckets_ - 1;
+        for (size_type i = 0; i < m_entries.size(); ++i)
+        {
+            std::uint32_t &head = m_buckets[m_entries[i].hash & mask];
+            m_entries[i].next = head;
+            head = static_cast<std::uint32_t>(i);
+        }
+    }
+} // Namespace ac.
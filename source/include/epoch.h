@@ -0,0 +1,236 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>       // std::atomic, std::atomic_flag, std::atomic_thread_fence
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <thread>       // std::this_thread::yield
+
+#include "hash_utils.h" // detail::CACHE_LINE
+
+namespace ac // Associative container
+{
+    /// Epoch-based memory reclamation. A thread that reads shared nodes pins the current epoch
+    /// for the duration of the read (an EpochGuard); a writer that unlinks a node retires it
+    /// instead of freeing it. The global epoch only advances once every pinned thread has
+    /// seen it, and a node retired in epoch `e` is freed once the epoch reaches `e + 2`, when
+    /// no thread can still hold a pointer to it.
+    ///
+    /// Pinning costs an acquire load, a store to the thread's own cache line and a fence; it
+    /// never performs an atomic read-modify-write. Retiring pushes the object onto a lock-free
+    /// stack with one compare-and-swap, and every COLLECT_EVERY retires the retiring thread
+    /// tries to become the collector: only one thread collects at a time, and the others skip
+    /// collecting instead of waiting, so no retire ever blocks. One process-wide domain,
+    /// EpochDomain::global(), serves every table.
+    class EpochDomain {
+        public:
+            using deleter_type = void (*)( void * );
+
+            EpochDomain( const EpochDomain & ) = delete;
+            EpochDomain & operator=( const EpochDomain & ) = delete;
+
+            ~EpochDomain()
+            {
+                // Nenhuma thread lê mais nada: tudo o que foi aposentado pode ser liberado
+                adopt_pending();
+                free_held( static_cast< std::uint64_t >( -1 ) );
+                for (Record *r = m_records.load(); r != nullptr;)
+                {
+                    Record *next = r->next;
+                    delete r;
+                    r = next;
+                }
+            }
+
+            /// The domain shared by every table of the library.
+            static EpochDomain & global()
+            {
+                static EpochDomain domain;
+                return domain;
+            }
+
+            /// Hands `p_` over to be freed by `deleter_( p_ )` once no pinned thread can see it.
+            /// Lock-free; call it after `p_` is unreachable to threads that pin from now on.
+            void retire( void * p_, deleter_type deleter_ )
+            {
+                // A época lida aqui é posterior a qualquer época fixada por quem ainda vê p_
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                Retired *r = new Retired{ p_, deleter_, m_epoch.load( std::memory_order_relaxed ), nullptr };
+                r->next = m_pending.load( std::memory_order_relaxed );
+                while (!m_pending.compare_exchange_weak( r->next, r, std::memory_order_release, std::memory_order_relaxed ))
+                {
+                }
+
+                if (m_retired.fetch_add( 1, std::memory_order_relaxed ) % COLLECT_EVERY == COLLECT_EVERY - 1
+                    && !m_collecting.test_and_set( std::memory_order_acquire ))
+                {
+                    // Quem não consegue ser o coletor segue em frente; o atual cuidará do que foi empilhado
+                    collect_locked();
+                    m_collecting.clear( std::memory_order_release );
+                }
+            }
+
+            /// Advances the epoch as far as the pinned threads allow, freeing what became safe.
+            /// Waits for a collection already running in another thread. Returns false if some
+            /// thread pinned an older epoch.
+            bool collect()
+            {
+                while (m_collecting.test_and_set( std::memory_order_acquire ))
+                {
+                    std::this_thread::yield();
+                }
+                const bool advanced = collect_locked();
+                m_collecting.clear( std::memory_order_release );
+                return advanced;
+            }
+
+            std::uint64_t epoch() const { return m_epoch.load( std::memory_order_acquire ); }
+
+        private:
+            friend class EpochGuard;
+
+            EpochDomain() = default;
+
+            /// One per thread that ever pinned this domain; reused after the thread exits.
+            struct alignas( detail::CACHE_LINE ) Record {
+                std::atomic< std::uint64_t > pinned{ 0 }; //!< (epoch << 1) | 1 while pinned, 0 otherwise.
+                std::atomic< bool > in_use{ true };
+                std::size_t depth{ 0 };                   //!< Nested guards; touched by the owner only.
+                Record *next{ nullptr };
+            };
+
+            /// Claims a free record or appends a new one. Done once per thread.
+            Record * acquire_record()
+            {
+                for (Record *r = m_records.load( std::memory_order_acquire ); r != nullptr; r = r->next)
+                {
+                    bool expected = false;
+                    if (!r->in_use.load( std::memory_order_relaxed )
+                        && r->in_use.compare_exchange_strong( expected, true, std::memory_order_acq_rel ))
+                        return r;
+                }
+                Record *r = new Record;
+                r->next = m_records.load( std::memory_order_relaxed );
+                while (!m_records.compare_exchange_weak( r->next, r, std::memory_order_release, std::memory_order_relaxed ))
+                {
+                }
+                return r;
+            }
+
+            /// This thread's record, released when the thread exits. There is a single domain,
+            /// so one thread-local registration is enough.
+            Record & local_record()
+            {
+                struct Registration {
+                    Record *record;
+                    ~Registration() { record->in_use.store( false, std::memory_order_release ); }
+                };
+                thread_local Registration reg{ acquire_record() };
+                return *reg.record;
+            }
+
+            /// Called by the one thread that holds m_collecting.
+            bool collect_locked()
+            {
+                adopt_pending();
+                const bool advanced = try_advance();
+
+                free_held( m_epoch.load( std::memory_order_relaxed ) );
+                return advanced;
+            }
+
+            /// Called by the collector.
+            bool try_advance()
+            {
+                const std::uint64_t e = m_epoch.load( std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+                for (Record *r = m_records.load( std::memory_order_acquire ); r != nullptr; r = r->next)
+                {
+                    const std::uint64_t pinned = r->pinned.load( std::memory_order_acquire );
+                    if (pinned != 0 && (pinned >> 1) != e)
+                        return false; // Uma thread ainda está numa época anterior
+                }
+
+                m_epoch.store( e + 1, std::memory_order_release );
+                return true;
+            }
+
+            struct Retired {
+                void *object;
+                deleter_type deleter;
+                std::uint64_t epoch;    //!< Época global quando foi aposentado.
+                Retired *next;
+            };
+
+            /// Moves everything retired since the last collection to the collector's list.
+            void adopt_pending()
+            {
+                for (Retired *r = m_pending.exchange( nullptr, std::memory_order_acquire ); r != nullptr;)
+                {
+                    Retired *next = r->next;
+                    r->next = m_held;
+                    m_held = r;
+                    r = next;
+                }
+            }
+
+            /// Frees the held objects that no thread pinned in epoch `now_` can see.
+            void free_held( std::uint64_t now_ )
+            {
+                Retired **link = &m_held;
+                while (*link != nullptr)
+                {
+                    Retired *r = *link;
+                    // Em e + 2, o que foi aposentado em e não é mais visível a ninguém
+                    if (r->epoch + 2 <= now_)
+                    {
+                        *link = r->next;
+                        r->deleter( r->object );
+                        delete r;
+                    }
+                    else
+                    {
+                        link = &r->next;
+                    }
+                }
+            }
+
+            static constexpr std::size_t COLLECT_EVERY = 64; //!< Retires between collection attempts.
+
+            std::atomic< std::uint64_t > m_epoch{ 1 };          //!< Época global.
+            std::atomic< Record * > m_records{ nullptr };       //!< Registros das threads.
+            std::atomic< Retired * > m_pending{ nullptr };      //!< Pilha de aposentados ainda não vistos pelo coletor.
+            std::atomic< std::size_t > m_retired{ 0 };          //!< Aposentados desde sempre; cadencia as coletas.
+            std::atomic_flag m_collecting = ATOMIC_FLAG_INIT;   //!< Tomado pela thread que coleta.
+            Retired *m_held{ nullptr };                         //!< Aposentados à espera da sua época; só o coletor toca.
+    };
+
+    /// Pins the epoch of a domain for its lifetime; guards nest.
+    class EpochGuard {
+        public:
+            explicit EpochGuard( EpochDomain & domain_ = EpochDomain::global() ) : m_record{ domain_.local_record() }
+            {
+                if (m_record.depth++ == 0)
+                {
+                    // Anuncia a época lida antes de ler qualquer nó; a barreira ordena o anúncio
+                    // antes das leituras seguintes, como exige o coletor
+                    const std::uint64_t e = domain_.m_epoch.load( std::memory_order_acquire );
+                    m_record.pinned.store( (e << 1) | 1, std::memory_order_relaxed );
+                    std::atomic_thread_fence( std::memory_order_seq_cst );
+                }
+            }
+
+            ~EpochGuard()
+            {
+                if (--m_record.depth == 0)
+                    m_record.pinned.store( 0, std::memory_order_release );
+            }
+
+            EpochGuard( const EpochGuard & ) = delete;
+            EpochGuard & operator=( const EpochGuard & ) = delete;
+
+        private:
+            EpochDomain::Record & m_record;
+    };
+} // namespace ac
+#endif
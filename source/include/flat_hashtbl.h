@@ -0,0 +1,160 @@
+#ifndef FLAT_HASHTBL_H
+#define FLAT_HASHTBL_H
+
+#include <cstdint>      // int8_t, uint32_t, uint64_t
+#include <cstring>      // memset, memcpy
+#include <algorithm>    // std::min, std::max
+#include <functional>   // std::hash, std::equal_to
+#include <iostream>     // ostream
+#include <initializer_list>
+#include <memory>       // std::allocator
+#include <stdexcept>    // std::out_of_range
+#include <utility>      // std::swap, std::move
+
+#if defined(__SSE2__)
+#include <emmintrin.h>  // _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+#include "hashtbl.h"    // HashEntry
+#include "hash_utils.h" // mix_hash
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        using ctrl_t = std::int8_t;
+
+        //! Control byte states. A full slot stores the 7-bit tag (H2) of its key, i.e. 0..127.
+        enum CtrlState : ctrl_t { kEmpty = -128, kDeleted = -2 };
+
+        //! Number of slots scanned by a single control group probe.
+        constexpr std::size_t kGroupWidth = 16;
+
+        /// Index of the lowest bit set in a non-zero mask.
+        inline unsigned lowest_bit( std::uint32_t mask_ )
+        {
+#if defined(__GNUC__)
+            return static_cast<unsigned>( __builtin_ctz( mask_ ) );
+#else
+            unsigned i{0};
+            while ( (mask_ & 1u) == 0 ) { mask_ >>= 1; ++i; }
+            return i;
+#endif
+        }
+
+        /// A window of kGroupWidth control bytes, matched all at once.
+        /// Each query returns a bit mask where bit `i` refers to the i-th slot of the group.
+        class CtrlGroup {
+            public:
+#if defined(__SSE2__)
+                explicit CtrlGroup( const ctrl_t * pos_ )
+                    : m_ctrl{ _mm_loadu_si128( reinterpret_cast<const __m128i*>( pos_ ) ) } {/*Empty*/}
+
+                std::uint32_t match( ctrl_t tag_ ) const
+                { return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( tag_ ), m_ctrl ) ) ); }
+
+                std::uint32_t match_empty() const { return match( kEmpty ); }
+
+                // Both kEmpty and kDeleted have the sign bit set, full slots don't.
+                std::uint32_t match_empty_or_deleted() const
+                { return static_cast<std::uint32_t>( _mm_movemask_epi8( m_ctrl ) ); }
+
+            private:
+                __m128i m_ctrl; //!< The 16 control bytes.
+#else
+                explicit CtrlGroup( const ctrl_t * pos_ ) { std::memcpy( m_ctrl, pos_, kGroupWidth ); }
+
+                std::uint32_t match( ctrl_t tag_ ) const
+                {
+                    std::uint32_t mask{0};
+                    for ( std::size_t i{0}; i < kGroupWidth; ++i )
+                        if ( m_ctrl[i] == tag_ ) mask |= 1u << i;
+                    return mask;
+                }
+
+                std::uint32_t match_empty() const { return match( kEmpty ); }
+
+                std::uint32_t match_empty_or_deleted() const
+                {
+                    std::uint32_t mask{0};
+                    for ( std::size_t i{0}; i < kGroupWidth; ++i )
+                        if ( m_ctrl[i] < 0 ) mask |= 1u << i;
+                    return mask;
+                }
+
+            private:
+                ctrl_t m_ctrl[kGroupWidth]; //!< The 16 control bytes.
+#endif
+        };
+    } // namespace detail
+
+    /// Open-addressing hash table in the "Swiss table" style.
+    /// Entries live in a single flat array of slots; a parallel array of 1-byte control tags
+    /// (empty, deleted, or 7 bits of the key's hash) is scanned 16 slots at a time, so most
+    /// lookups compare a single key and never chase a pointer.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class FlatHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using size_type  = std::size_t;
+
+            explicit FlatHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            FlatHashTbl( const FlatHashTbl& );
+            FlatHashTbl( const std::initializer_list< entry_type > & );
+            FlatHashTbl& operator=( const FlatHashTbl& );
+            FlatHashTbl& operator=( const std::initializer_list< entry_type > & );
+
+            virtual ~FlatHashTbl();
+
+            bool insert( const KeyType &, const DataType &  );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool erase( const KeyType & );
+            void clear();
+            bool empty() const;
+            inline size_type size() const { return m_count; };
+            DataType& at( const KeyType& );
+            DataType& operator[]( const KeyType& );
+            size_type count( const KeyType& ) const;
+            float max_load_factor() const;
+            void max_load_factor(float mlf);
+
+            friend std::ostream & operator<<( std::ostream & os_, const FlatHashTbl & ht_ ) {
+                for (size_type i = 0; i < ht_.m_capacity; ++i) {
+                    if ( ht_.m_ctrl[i] >= 0 ) {
+                        os_ << "{" << ht_.m_slots[i].m_key << "," << ht_.m_slots[i].m_data << "} ";
+                    }
+                }
+                return os_;
+            }
+
+        private:
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            static size_type hash_of( const KeyType & );
+            size_type find_index( const KeyType &, size_type ) const;
+            size_type find_insert_slot( size_type ) const;
+            size_type insert_new( size_type, const KeyType &, const DataType & );
+            size_type max_elements( size_type ) const;
+            size_type capacity_for( size_type ) const;
+            void allocate( size_type );
+            void release();
+            void resize( size_type );
+            void swap( FlatHashTbl & );
+
+        private:
+            size_type m_capacity;     //!< Number of slots; a power of two multiple of the group width.
+            size_type m_count;        //!< Number of elements in the table.
+            size_type m_growth_left;  //!< Empty slots we may still fill before growing.
+            float m_max_load_factor;  //!< Ratio of full (or deleted) slots that triggers growth.
+            detail::ctrl_t *m_ctrl;   //!< Control tag of each slot.
+            entry_type *m_slots;      //!< Raw slot storage; only slots with a full tag are constructed.
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "flat_hashtbl.inl"
+#endif
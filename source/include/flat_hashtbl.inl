@@ -0,0 +1,377 @@
+#include "flat_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::FlatHashTbl(size_type sz)
+        : m_capacity{0}, m_count{0}, m_growth_left{0}, m_max_load_factor{0.875f}, m_ctrl{nullptr}, m_slots{nullptr}
+    {
+        allocate(capacity_for(sz));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::FlatHashTbl(const FlatHashTbl &source)
+        : m_capacity{0}, m_count{0}, m_growth_left{0}, m_max_load_factor{source.m_max_load_factor}, m_ctrl{nullptr}, m_slots{nullptr}
+    {
+        allocate(source.m_capacity);
+
+        // Copia os slots na mesma posição (inclusive marcas de remoção), sem re-hash
+        std::memcpy(m_ctrl, source.m_ctrl, m_capacity);
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_ctrl[i] >= 0)
+            {
+                ::new (static_cast<void *>(m_slots + i)) entry_type(source.m_slots[i]);
+            }
+        }
+        m_count = source.m_count;
+        m_growth_left = source.m_growth_left;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::FlatHashTbl(const std::initializer_list<entry_type> &ilist)
+        : FlatHashTbl(ilist.size())
+    {
+        for (const auto &entry : ilist)
+        {
+            insert(entry.m_key, entry.m_data);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const FlatHashTbl &clone)
+    {
+        if (this == &clone)
+            return *this;
+
+        FlatHashTbl copy(clone);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const std::initializer_list<entry_type> &ilist)
+    {
+        FlatHashTbl copy(ilist);
+        copy.max_load_factor(m_max_load_factor);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::~FlatHashTbl()
+    {
+        release();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        const size_type hash = hash_of(key_);
+        const size_type i = find_index(key_, hash);
+
+        if (i != npos)
+        {
+            m_slots[i].m_data = new_data_; // A chave já existe: apenas atualiza o dado
+            return false;
+        }
+
+        insert_new(hash, key_, new_data_);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const size_type i = find_index(key_, hash_of(key_));
+
+        if (i != npos)
+        {
+            data_item_ = m_slots[i].m_data; // Armazena o dado encontrado na variável de saída
+            return true;
+        }
+
+        return false; // A chave não foi encontrada
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        const size_type i = find_index(key_, hash_of(key_));
+
+        if (i == npos)
+            return false;
+
+        m_slots[i].~entry_type();
+        --m_count;
+
+        // Se o grupo ainda tem um slot vazio, nenhuma sondagem passou por ele e o slot
+        // pode voltar a ser vazio; caso contrário, deixamos uma marca de remoção.
+        const size_type group = i & ~(detail::kGroupWidth - 1);
+        if (detail::CtrlGroup{m_ctrl + group}.match_empty() != 0)
+        {
+            m_ctrl[i] = detail::kEmpty;
+            ++m_growth_left;
+        }
+        else
+        {
+            m_ctrl[i] = detail::kDeleted;
+        }
+
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_ctrl[i] >= 0)
+            {
+                m_slots[i].~entry_type();
+            }
+        }
+        std::memset(m_ctrl, detail::kEmpty, m_capacity);
+        m_count = 0;
+        m_growth_left = max_elements(m_capacity);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::empty() const
+    {
+        return m_count == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        const size_type i = find_index(key_, hash_of(key_));
+
+        if (i != npos)
+        {
+            return m_slots[i].m_data;
+        }
+
+        throw std::out_of_range("Key not found in FlatHashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        const size_type hash = hash_of(key_);
+        size_type i = find_index(key_, hash);
+
+        if (i == npos)
+        {
+            // Insere uma nova entrada com a chave e um valor padrão para o dado
+            i = insert_new(hash, key_, DataType());
+        }
+
+        return m_slots[i].m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    {
+        // Não há buckets compartilhados em endereçamento aberto: a chave está ou não está.
+        return find_index(key_, hash_of(key_)) != npos ? 1 : 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    float FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor(float mlf)
+    {
+        // Precisamos sempre de pelo menos um slot vazio para encerrar as sondagens.
+        m_max_load_factor = std::min(std::max(mlf, 0.125f), 0.9375f);
+        resize(capacity_for(m_count));
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::hash_of(const KeyType &key_)
+    {
+        return static_cast<size_type>(detail::mix_hash(KeyHash()(key_)));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_index(const KeyType &key_, size_type hash_) const
+    {
+        const auto tag = static_cast<detail::ctrl_t>(hash_ & 0x7F);
+        const size_type mask = m_capacity / detail::kGroupWidth - 1;
+        size_type group = (hash_ >> 7) & mask;
+
+        // Sondagem triangular sobre grupos: visita todos os grupos de uma tabela 2^k.
+        for (size_type step = 1;; ++step)
+        {
+            const size_type base = group * detail::kGroupWidth;
+            const detail::CtrlGroup ctrl{m_ctrl + base};
+
+            for (auto bits = ctrl.match(tag); bits != 0; bits &= bits - 1)
+            {
+                const size_type i = base + detail::lowest_bit(bits);
+                if (KeyEqual()(m_slots[i].m_key, key_))
+                {
+                    return i;
+                }
+            }
+
+            if (ctrl.match_empty() != 0)
+            {
+                return npos; // Um slot vazio encerra a sequência de sondagem
+            }
+
+            group = (group + step) & mask;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_insert_slot(size_type hash_) const
+    {
+        const size_type mask = m_capacity / detail::kGroupWidth - 1;
+        size_type group = (hash_ >> 7) & mask;
+
+        for (size_type step = 1;; ++step)
+        {
+            const size_type base = group * detail::kGroupWidth;
+            const auto bits = detail::CtrlGroup{m_ctrl + base}.match_empty_or_deleted();
+
+            if (bits != 0)
+            {
+                return base + detail::lowest_bit(bits);
+            }
+
+            group = (group + step) & mask;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert_new(size_type hash_, const KeyType &key_, const DataType &data_)
+    {
+        size_type i = find_insert_slot(hash_);
+
+        if (m_growth_left == 0 && m_ctrl[i] != detail::kDeleted)
+        {
+            // Muitas marcas de remoção: reconstrói no mesmo tamanho; senão, dobra a tabela.
+            if (m_count * 2 <= max_elements(m_capacity))
+                resize(m_capacity);
+            else
+                resize(m_capacity * 2);
+            i = find_insert_slot(hash_);
+        }
+
+        ::new (static_cast<void *>(m_slots + i)) entry_type(key_, data_);
+        if (m_ctrl[i] == detail::kEmpty)
+        {
+            --m_growth_left;
+        }
+        m_ctrl[i] = static_cast<detail::ctrl_t>(hash_ & 0x7F);
+        ++m_count;
+
+        return i;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_elements(size_type capacity_) const
+    {
+        const auto limit = static_cast<size_type>(capacity_ * m_max_load_factor);
+        return limit < capacity_ ? limit : capacity_ - 1;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::capacity_for(size_type n_) const
+    {
+        size_type capacity = detail::kGroupWidth;
+        while (max_elements(capacity) < n_)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::allocate(size_type capacity_)
+    {
+        m_slots = std::allocator<entry_type>().allocate(capacity_);
+        m_ctrl = new detail::ctrl_t[capacity_];
+        std::memset(m_ctrl, detail::kEmpty, capacity_);
+        m_capacity = capacity_;
+        m_count = 0;
+        m_growth_left = max_elements(capacity_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::release()
+    {
+        if (m_ctrl == nullptr)
+            return;
+
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_ctrl[i] >= 0)
+            {
+                m_slots[i].~entry_type();
+            }
+        }
+        std::allocator<entry_type>().deallocate(m_slots, m_capacity);
+        delete[] m_ctrl;
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::resize(size_type new_capacity_)
+    {
+        detail::ctrl_t *old_ctrl = m_ctrl;
+        entry_type *old_slots = m_slots;
+        const size_type old_capacity = m_capacity;
+        const size_type count = m_count;
+
+        allocate(new_capacity_);
+
+        // Move cada entrada para o novo arranjo; como as chaves são distintas, não há busca.
+        for (size_type i = 0; i < old_capacity; ++i)
+        {
+            if (old_ctrl[i] < 0)
+                continue;
+
+            const size_type hash = hash_of(old_slots[i].m_key);
+            const size_type j = find_insert_slot(hash);
+            ::new (static_cast<void *>(m_slots + j)) entry_type(std::move(old_slots[i]));
+            m_ctrl[j] = static_cast<detail::ctrl_t>(hash & 0x7F);
+            old_slots[i].~entry_type();
+        }
+        m_count = count;
+        m_growth_left -= count;
+
+        std::allocator<entry_type>().deallocate(old_slots, old_capacity);
+        delete[] old_ctrl;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FlatHashTbl<KeyType, DataType, KeyHash, KeyEqual>::swap(FlatHashTbl &other)
+    {
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_count, other.m_count);
+        std::swap(m_growth_left, other.m_growth_left);
+        std::swap(m_max_load_factor, other.m_max_load_factor);
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+    }
+} // Namespace ac.
@@ -0,0 +1,83 @@
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+#include <algorithm> // std::min, std::max
+#include <cmath>     // std::ceil
+#include <cstddef>   // size_t
+
+namespace ac // Associative container
+{
+    // A growth policy decides when the chained table resizes and how many buckets it asks for;
+    // the index policy then rounds that request to a valid bucket count. Every policy offers:
+    //   float max_load_factor() const / void max_load_factor( mlf )
+    //   size_type grow_to( count, buckets ) const   -> 0 if `count` entries fit, else the new size;
+    //   size_type shrink_to( count, buckets ) const -> 0 to keep `buckets`, else the new size;
+    //   size_type buckets_for( count ) const        -> the smallest size that holds `count` entries.
+
+    /// Grows by `growth_factor` once the load exceeds `max_load_factor`, and never shrinks.
+    /// Setting a `min_load_factor` above zero also shrinks the table after mass erasure.
+    /// Hysteresis: a shrink aims at the midpoint of the two bounds, and the minimum is clamped
+    /// to at most half of max/growth_factor (the index policy may round a new size up to nearly
+    /// twice the request), so neither a grow nor a shrink can be undone by the next operation.
+    struct LoadFactorPolicy {
+        using size_type = std::size_t;
+
+        explicit LoadFactorPolicy( float max_load_factor_ = 1.0f, float growth_factor_ = 2.0f,
+                                   float min_load_factor_ = 0.0f )
+            : m_growth_factor{ std::max( growth_factor_, 1.25f ) }
+        {
+            max_load_factor( max_load_factor_ );
+            min_load_factor( min_load_factor_ );
+        }
+
+        float growth_factor() const { return m_growth_factor; }
+        float max_load_factor() const { return m_max_load_factor; }
+        float min_load_factor() const { return m_min_load_factor; }
+
+        void max_load_factor( float mlf_ )
+        {
+            m_max_load_factor = std::max( mlf_, 0.125f );
+            min_load_factor( m_min_load_factor );
+        }
+
+        void min_load_factor( float mlf_ )
+        {
+            // Acima de max/growth, a tabela recém-crescida já estaria abaixo do mínimo; a metade
+            // cobre o arredondamento do tamanho pela política de índice.
+            const float ceiling = m_max_load_factor / m_growth_factor * 0.5f;
+            m_min_load_factor = std::min( std::max( mlf_, 0.0f ), ceiling );
+        }
+
+        size_type buckets_for( size_type count_ ) const
+        {
+            return static_cast<size_type>( std::ceil( count_ / m_max_load_factor ) );
+        }
+
+        size_type grow_to( size_type count_, size_type buckets_ ) const
+        {
+            if (count_ <= m_max_load_factor * buckets_)
+                return 0;
+            return std::max( static_cast<size_type>( buckets_ * m_growth_factor ), buckets_for( count_ ) );
+        }
+
+        size_type shrink_to( size_type count_, size_type buckets_ ) const
+        {
+            if (m_min_load_factor == 0.0f || count_ >= m_min_load_factor * buckets_)
+                return 0;
+            const float target = (m_min_load_factor + m_max_load_factor) * 0.5f;
+            return static_cast<size_type>( std::ceil( count_ / target ) );
+        }
+
+        float m_growth_factor{2.0f};    //!< Size multiplier applied on growth.
+        float m_max_load_factor{1.0f};  //!< Load above which the table grows.
+        float m_min_load_factor{0.0f};  //!< Load below which the table shrinks; 0 never shrinks.
+    };
+
+    /// LoadFactorPolicy that shrinks once the table falls under a quarter of its maximum load.
+    struct ShrinkingPolicy : LoadFactorPolicy {
+        explicit ShrinkingPolicy( float max_load_factor_ = 1.0f, float growth_factor_ = 2.0f )
+            : LoadFactorPolicy{ max_load_factor_, growth_factor_, max_load_factor_ * 0.25f } {}
+    };
+
+} // namespace ac
+#endif
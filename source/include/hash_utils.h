@@ -0,0 +1,62 @@
+#ifndef HASH_UTILS_H
+#define HASH_UTILS_H
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <functional>   // std::hash
+#include <string_view>  // std::string_view
+#include <type_traits>  // std::enable_if_t, std::void_t
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        //! Assumed cache line size, for padding data written by different threads.
+        constexpr std::size_t CACHE_LINE = 64;
+
+        /// Finalizer of MurmurHash3: spreads weak hashes (e.g. identity for ints) over all bits.
+        inline std::uint64_t mix_hash( std::uint64_t h_ )
+        {
+            h_ ^= h_ >> 33;
+            h_ *= 0xff51afd7ed558ccdULL;
+            h_ ^= h_ >> 33;
+            h_ *= 0xc4ceb9fe1a85ec53ULL;
+            h_ ^= h_ >> 33;
+            return h_;
+        }
+
+        /// Hints the CPU to start loading the cache line at `p_` for reading; a no-op where
+        /// the compiler has no prefetch builtin.
+        inline void prefetch( const void * p_ )
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch( p_, 0, 3 );
+#else
+            (void) p_;
+#endif
+        }
+
+        /// Whether a hash or equality functor declares `is_transparent`.
+        template< class T, class = void >
+        struct is_transparent : std::false_type {};
+
+        template< class T >
+        struct is_transparent< T, std::void_t< typename T::is_transparent > > : std::true_type {};
+
+        /// Enables a lookup overload for a key type `K` other than `Key` when both functors are
+        /// transparent, i.e. they hash and compare `K` consistently with `Key`.
+        template< class Hash, class Equal, class K, class Key >
+        using enable_heterogeneous_t = std::enable_if_t< is_transparent<Hash>::value
+                                                         && is_transparent<Equal>::value
+                                                         && !std::is_same<std::decay_t<K>, Key>::value >;
+    } // namespace detail
+
+    /// Transparent hash for string keys: std::string, std::string_view and C strings all hash
+    /// alike, so lookups never build a temporary std::string. Pair it with std::equal_to<>.
+    struct StringHash {
+        using is_transparent = void;
+
+        std::size_t operator()( std::string_view s_ ) const { return std::hash<std::string_view>{}( s_ ); }
+    };
+} // namespace ac
+#endif
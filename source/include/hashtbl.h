@@ -11,16 +11,47 @@
 #include <initializer_list>
 #include <utility> // std::pair
 #include <tuple>
+#include <memory>  // std::allocator, std::allocator_traits
+#include <type_traits> // std::is_arithmetic, std::bool_constant
+#include <stdexcept>   // std::out_of_range, std::length_error
+#include <cassert>     // assert
+#include <thread>      // std::thread
+#include <exception>   // std::exception_ptr
+#include <mutex>       // std::mutex, std::lock_guard
+#include <vector>      // bulk insertion staging
+#include <new>         // ::operator new, placement new
+#include <cstdint>     // std::uint64_t
+
+#include "index_policy.h"
+#include "growth_policy.h"
+#include "pool_allocator.h"
+#include "hash_utils.h"
+#include "occupancy_bitmap.h"
+#include "span.h"
 
 namespace ac // Associative container
 {
-	template<class KeyType, class DataType>
+	/// Whether the chained table caches each key's full hash in its entry. On by default for
+	/// every key that is not a number, enum or pointer, i.e. whenever hashing and comparing the
+	/// key is likely to cost more than a word of memory per entry. Specialize to override.
+	template<class KeyType>
+	struct store_hash : std::bool_constant< !( std::is_arithmetic<KeyType>::value
+	                                           || std::is_enum<KeyType>::value
+	                                           || std::is_pointer<KeyType>::value ) > {};
+
+	template<class KeyType, class DataType, bool StoreHash = false>
 	struct HashEntry {
         KeyType m_key;   //! Data key
         DataType m_data; //! The data
 
         // Regular constructor.
-        HashEntry( KeyType kt_, DataType dt_ ) : m_key{kt_} , m_data{dt_} {/*Empty*/}
+        HashEntry( KeyType kt_, DataType dt_ ) : m_key(std::move(kt_)) , m_data(std::move(dt_)) {/*Empty*/}
+
+        /// Builds the key and the data in place from the arguments packed in each tuple.
+        template< class... KeyArgs, class... DataArgs >
+        HashEntry( std::piecewise_construct_t, std::tuple<KeyArgs...> key_args_, std::tuple<DataArgs...> data_args_ )
+            : m_key( std::make_from_tuple<KeyType>( std::move(key_args_) ) ),
+              m_data( std::make_from_tuple<DataType>( std::move(data_args_) ) ) {/*Empty*/}
 
         /*friend std::ostream & operator<<( std::ostream & os_, const HashEntry & he_ ) {
             os_ << "{" << he_.m_key << "," << he_.m_data << "}";
@@ -35,26 +66,154 @@ namespace ac // Associative container
 
     };
 
+    /// Entry that also keeps the full hash of its key: chain walks compare hashes before
+    /// calling KeyEqual, and rehashing never calls KeyHash again.
+	template<class KeyType, class DataType>
+	struct HashEntry<KeyType, DataType, true> : HashEntry<KeyType, DataType, false> {
+        std::size_t m_hash; //! Cached KeyHash()(m_key)
+
+        /// The hash first, then any arguments of the plain entry's constructors.
+        template< class... Args >
+        HashEntry( std::size_t hash_, Args&&... args_ )
+            : HashEntry<KeyType, DataType, false>( std::forward<Args>(args_)... ) , m_hash{hash_} {/*Empty*/}
+    };
+
+    namespace detail
+    {
+        /// Key and data of the elements accepted by the bulk interface: table entries and pairs.
+        template< class K, class D, bool S >
+        const K & key_of( const HashEntry<K, D, S> & e_ ) { return e_.m_key; }
+        template< class K, class D, bool S >
+        const D & data_of( const HashEntry<K, D, S> & e_ ) { return e_.m_data; }
+        template< class K, class D >
+        const K & key_of( const std::pair<K, D> & p_ ) { return p_.first; }
+        template< class K, class D >
+        const D & data_of( const std::pair<K, D> & p_ ) { return p_.second; }
+
+        /// Enables the iterator-range overloads only for iterators.
+        template< class It >
+        using enable_if_iterator_t = std::void_t< typename std::iterator_traits<It>::iterator_category >;
+    } // namespace detail
+
 	template< class KeyType,
 		      class DataType,
 		      class KeyHash = std::hash< KeyType >,
-		      class KeyEqual = std::equal_to< KeyType > >
+		      class KeyEqual = std::equal_to< KeyType >,
+		      class IndexPolicy = PrimeModPolicy,
+		      class GrowthPolicy = LoadFactorPolicy,
+		      class Allocator = std::allocator< HashEntry< KeyType, DataType > > >
 	class HashTbl {
         public:
             // Aliases
             using entry_type = HashEntry<KeyType,DataType>;
-            using list_type  = std::forward_list< entry_type >;
+            using node_type  = HashEntry<KeyType,DataType,store_hash<KeyType>::value>;
+            using allocator_type = Allocator;
+            using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc< node_type >;
+            using list_type  = std::forward_list< node_type, node_allocator >;
             using size_type  = std::size_t;
+            using local_iterator       = typename list_type::iterator;
+            using const_local_iterator = typename list_type::const_iterator;
+
+            /// Iterator over the entries of the table. Do not change an entry's key through it.
+            /// Any insertion or erasure may rehash and invalidates every iterator.
+            template< bool IsConst >
+            class Iterator {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type        = entry_type;
+                    using difference_type   = std::ptrdiff_t;
+                    using pointer           = std::conditional_t< IsConst, const entry_type *, entry_type * >;
+                    using reference         = std::conditional_t< IsConst, const entry_type &, entry_type & >;
+
+                    Iterator() = default;
+                    /// An iterator converts to a const_iterator.
+                    template< bool WasConst, class = std::enable_if_t< IsConst && !WasConst > >
+                    Iterator( const Iterator< WasConst > & other_ )
+                        : m_owner{ other_.m_owner }, m_pos{ other_.m_pos }, m_node{ other_.m_node } {}
+
+                    reference operator*() const { return *m_node; }
+                    pointer operator->() const { return &*m_node; }
+
+                    Iterator & operator++()
+                    {
+                        // Fim do bucket: salta para o próximo bucket ocupado
+                        if (++m_node == m_owner->bucket_at( m_pos ).end())
+                            *this = HashTbl::first_from( *m_owner, m_pos + 1 );
+                        return *this;
+                    }
+                    Iterator operator++( int ) { Iterator old{ *this }; ++*this; return old; }
 
-            explicit HashTbl( size_type table_sz_ = DEFAULT_SIZE );
-            HashTbl( const HashTbl& );
+                    bool operator==( const Iterator & rhs_ ) const { return m_pos == rhs_.m_pos && m_node == rhs_.m_node; }
+                    bool operator!=( const Iterator & rhs_ ) const { return !( *this == rhs_ ); }
+
+                private:
+                    friend class HashTbl;
+                    template< bool > friend class Iterator;
+
+                    using owner_type = std::conditional_t< IsConst, const HashTbl *, HashTbl * >;
+                    using node_iter  = std::conditional_t< IsConst, typename list_type::const_iterator,
+                                                                    typename list_type::iterator >;
+
+                    Iterator( owner_type owner_, size_type pos_, node_iter node_ )
+                        : m_owner{ owner_ }, m_pos{ pos_ }, m_node{ node_ } {}
+
+                    owner_type m_owner{ nullptr }; //!< The table iterated over.
+                    size_type m_pos{ END_POS };    //!< Bucket position (see locate()); END_POS at the end.
+                    node_iter m_node{};            //!< The entry within that bucket.
+            };
+            using iterator       = Iterator< false >;
+            using const_iterator = Iterator< true >;
+
+            explicit HashTbl( size_type table_sz_ = DEFAULT_SIZE, const GrowthPolicy & growth_ = GrowthPolicy(),
+                              const Allocator & alloc_ = Allocator() );
+            /// Copies the buckets of `source_` in `threads_` ranges at once; 0 means one thread
+            /// per hardware thread. The threads allocate nodes, so they are only started for
+            /// large tables with a stateless allocator (PoolAllocator is not thread-safe).
+            /// An exception thrown by a copy on any thread reaches the caller once every thread
+            /// has joined.
+            HashTbl( const HashTbl & source_, size_type threads_ = 1 );
+            HashTbl( HashTbl&& ) noexcept( std::is_nothrow_copy_constructible<node_allocator>::value );
             HashTbl( const std::initializer_list< entry_type > & );
+            /// Builds the table from a range of entries or pairs through insert_bulk().
+            template< class InputIt, class = detail::enable_if_iterator_t< InputIt > >
+            HashTbl( InputIt first_, InputIt last_, size_type table_sz_ = DEFAULT_SIZE,
+                     const GrowthPolicy & growth_ = GrowthPolicy(), const Allocator & alloc_ = Allocator() );
             HashTbl& operator=( const HashTbl& );
+            HashTbl& operator=( HashTbl&& ) noexcept( std::is_nothrow_copy_constructible<node_allocator>::value );
             HashTbl& operator=( const std::initializer_list< entry_type > & );
 
             virtual ~HashTbl();
 
             bool insert( const KeyType &, const DataType &  );
+            bool insert( KeyType &&, DataType && );
+            /// Builds an entry from `args_` right in its node; if the key is already present the
+            /// node is discarded and the table is left unchanged.
+            template< class... Args >
+            bool emplace( Args&&... args_ );
+            /// Builds the data from `args_` in place only if `key_` is absent; otherwise the
+            /// arguments are not touched (not even moved from).
+            template< class... Args >
+            bool try_emplace( const KeyType & key_, Args&&... args_ );
+            template< class... Args >
+            bool try_emplace( KeyType && key_, Args&&... args_ );
+            /// Inserts, or assigns `obj_` to the data of an existing key. Returns true on insertion.
+            template< class M >
+            bool insert_or_assign( const KeyType & key_, M && obj_ );
+            template< class M >
+            bool insert_or_assign( KeyType && key_, M && obj_ );
+            /// Inserts a range of entries (`HashEntry` or `std::pair`) in one pass: the table is
+            /// sized once for the whole range, and the entries are radix-partitioned by bucket
+            /// range so that the writes of each partition stay within a cache-sized slice of the
+            /// bucket array. A repeated key assigns its data, the last occurrence winning, as
+            /// with insert(). With `keys_unique_` the caller asserts that no key of the range is
+            /// repeated or already present, and the per-entry chain scan is skipped (debug
+            /// builds still check it). `threads_` threads hash and partition the range; 0 means
+            /// one per hardware thread. Single-pass input iterators fall back to insert().
+            /// Returns the number of entries inserted. If KeyHash throws, on any thread, the
+            /// exception reaches the caller once every thread has joined, before any entry of
+            /// the range is inserted.
+            template< class InputIt, class = detail::enable_if_iterator_t< InputIt > >
+            size_type insert_bulk( InputIt first_, InputIt last_, bool keys_unique_ = false, size_type threads_ = 1 );
             bool retrieve( const KeyType &, DataType & ) const;
             bool erase( const KeyType & );
             void clear();
@@ -62,29 +221,192 @@ namespace ac // Associative container
             inline size_type size() const { return m_count; };
             DataType& at( const KeyType& );
             DataType& operator[]( const KeyType& );
+            DataType& operator[]( KeyType&& );
             size_type count( const KeyType& ) const;
+
+            //=== Lookups that neither copy the data nor throw on a miss.
+            iterator find( const KeyType & );
+            const_iterator find( const KeyType & ) const;
+            /// Address of the data of `key_`, or nullptr if the key is absent.
+            DataType * find_ptr( const KeyType & );
+            const DataType * find_ptr( const KeyType & ) const;
+            bool contains( const KeyType & ) const;
+
+            //=== Batched lookups, software-pipelined: a key is hashed and its bucket head
+            // prefetched BATCH_GROUP keys before its first node is prefetched, and that
+            // BATCH_GROUP keys before it is compared, so dozens of cache misses are in flight
+            // at once instead of one lookup stalling after another.
+            /// `out_[i]` gets the address of the data of `keys_[i]`, or nullptr on a miss.
+            /// Returns the number of hits; throws std::length_error if `out_` is too short.
+            size_type retrieve_batch( span< const KeyType > keys_, span< DataType * > out_ );
+            size_type retrieve_batch( span< const KeyType > keys_, span< const DataType * > out_ ) const;
+            /// How many of `keys_` are in the table.
+            size_type count_batch( span< const KeyType > keys_ ) const;
+            /// Same results as retrieve_batch(), scheduled per chain node instead of per key:
+            /// `width_` lookups are in flight, each a small state machine that prefetches its
+            /// bucket head or next node and then yields to the next lookup, round-robin. A long
+            /// chain only holds up its own lane, which fixed-distance pipelining cannot do.
+            size_type interleaved_find( span< const KeyType > keys_, span< DataType * > out_,
+                                        size_type width_ = DEFAULT_INTERLEAVE );
+            size_type interleaved_find( span< const KeyType > keys_, span< const DataType * > out_,
+                                        size_type width_ = DEFAULT_INTERLEAVE ) const;
+
+            //=== Iteration, in bucket order. Empty buckets are skipped through an occupancy
+            // bitmap, so a sparse table costs one bit test per empty bucket, not a list visit.
+            iterator begin();
+            const_iterator begin() const;
+            const_iterator cbegin() const;
+            iterator end();
+            const_iterator end() const;
+            const_iterator cend() const;
+
+            //=== Heterogeneous lookup: with transparent KeyHash and KeyEqual (`is_transparent`),
+            // any key type they accept can be looked up without building a KeyType.
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            bool retrieve( const K &, DataType & ) const;
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            bool erase( const K & );
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            DataType& at( const K & );
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            size_type count( const K & ) const;
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            iterator find( const K & );
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            const_iterator find( const K & ) const;
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            DataType * find_ptr( const K & );
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            const DataType * find_ptr( const K & ) const;
+            template< class K, class = detail::enable_heterogeneous_t< KeyHash, KeyEqual, K, KeyType > >
+            bool contains( const K & ) const;
             float max_load_factor() const;
             void max_load_factor(float mlf);
+            float load_factor() const;
+            inline size_type bucket_count() const { return m_size; }
+
+            //=== Bucket interface, over the current bucket array. During an incremental
+            // migration the entries still in the old array belong to no bucket `n_`;
+            // `rehash( bucket_count() )` completes the migration.
+            /// Index of the bucket `key_` maps to. Requires `bucket_count() > 0`.
+            size_type bucket( const KeyType & key_ ) const;
+            size_type bucket_size( size_type n_ ) const;
+            local_iterator begin( size_type n_ ) { return m_table[n_].begin(); }
+            const_local_iterator begin( size_type n_ ) const { return m_table[n_].begin(); }
+            const_local_iterator cbegin( size_type n_ ) const { return m_table[n_].cbegin(); }
+            local_iterator end( size_type n_ ) { return m_table[n_].end(); }
+            const_local_iterator end( size_type n_ ) const { return m_table[n_].end(); }
+            const_local_iterator cend( size_type n_ ) const { return m_table[n_].cend(); }
+            inline allocator_type get_allocator() const { return allocator_type( m_alloc ); }
+
+            /// Sizes the table for at least `n_` buckets, and never fewer than the current
+            /// elements need under the max load factor; `rehash(0)` shrinks to fit. Nodes are
+            /// relinked into the new buckets, never reallocated or copied, and no entry is moved.
+            /// A serial resize makes a single allocation: one block holds the bucket array and
+            /// its occupancy bitmap. With `threads_` other than 1 (0 means one per hardware
+            /// thread), each thread unlinks the nodes of a range of old buckets into one list
+            /// per range of new buckets, then links the lists of its own ranges into the new
+            /// buckets, so no two threads ever touch the same list; those scratch lists and the
+            /// threads are allocated too. The order of every chain is the one a serial rehash
+            /// gives. Small tables stay serial.
+            void rehash( size_type n_, size_type threads_ = 1 );
+            /// Makes room for `n_` elements without further growth. Never shrinks.
+            void reserve( size_type n_ );
+
+            //=== Incremental rehash: grow without moving the whole table at once.
+            bool incremental_rehash() const;
+            void incremental_rehash( bool enable_, size_type buckets_per_step_ = DEFAULT_REHASH_STEP );
+            /// Whether an incremental migration is in progress (both bucket arrays are live).
+            inline bool rehashing() const { return m_old_table != nullptr; }
 
             friend std::ostream & operator<<( std::ostream & os_, const HashTbl & ht_ ) {
-                for (size_type i = 0; i < ht_.m_size; ++i) {
-                    for (const auto& entry : ht_.m_table[i]) {
-                        os_ << "{" << entry.m_key << "," << entry.m_data << "} ";
-                    }
+                for (const auto& entry : ht_) {
+                    os_ << "{" << entry.m_key << "," << entry.m_data << "} ";
                 }
                 return os_;
             }
 
         private:
-            static size_type find_next_prime( size_type );
-            void rehash( void );
+            static size_type hash_of( const node_type & );
+            template< class K >
+            static bool matches( const node_type &, const K &, size_type );
+            list_type * new_buckets( size_type );
+            static void free_buckets( list_type *, size_type );
+            static size_type words_offset( size_type );
+            static std::uint64_t * occupancy_words( list_type *, size_type );
+            template< class... Args >
+            node_type & emplace_node( list_type &, size_type, Args&&... );
+            template< class K, class D >
+            bool insert_impl( K &&, D && );
+            template< class K, class... Args >
+            std::pair< node_type *, bool > try_emplace_impl( K &&, Args&&... );
+            template< class K >
+            node_type * find_node( const K &, size_type );
+            template< class K >
+            const node_type * find_node( const K &, size_type ) const;
+            template< class K >
+            bool erase_node( const K & );
+            template< class Table, class K >
+            static Iterator< std::is_const<Table>::value > find_in( Table &, const K & );
+            template< class Table >
+            static Iterator< std::is_const<Table>::value > first_from( Table &, size_type );
+            template< class Table, class Visit >
+            static size_type lookup_batch( Table &, span< const KeyType >, Visit );
+            template< class Table, class Visit >
+            static size_type lookup_interleaved( Table &, span< const KeyType >, size_type, Visit );
+            size_type next_occupied( size_type ) const;
+            void mark_occupied( size_type, bool );
+            void rebuild_occupied();
+            template< class Fn >
+            static void run_workers( size_type, Fn );
+            static size_type workers_for( size_type, size_type );
+            void steal( HashTbl & );
+            size_type locate( size_type ) const;
+            list_type & bucket_at( size_type );
+            const list_type & bucket_at( size_type ) const;
+            list_type & bucket_of( size_type );
+            const list_type & bucket_of( size_type ) const;
+            list_type & grow_for_insert( size_type );
+            void shrink_after_erase();
+            void resize( size_type, size_type threads_ = 1 );
+            void move_parallel( list_type *, size_type, const IndexPolicy &, size_type );
+            void rehash_step();
+            void finish_rehash();
+            void copy_from( const HashTbl &, size_type threads_ = 1 );
 
         private:
             size_type m_size; //!< Tamanho da tabela.
             size_type m_count;//!< Numero de elementos na tabel.
             // std::unique_ptr< std::forward_list< entry_type > [] > m_table;
-            std::forward_list< entry_type > *m_table; //!< Tabela de listas para entradas de tabela.
+            list_type *m_table; //!< Tabela de listas para entradas de tabela.
+            IndexPolicy m_index; //!< Mapeia o hash de uma chave para um bucket.
+            GrowthPolicy m_growth; //!< Decide quando e para quanto a tabela cresce ou encolhe.
+            node_allocator m_alloc; //!< Alocador dos nós, compartilhado por todas as listas.
+            detail::OccupancyBitmap m_occupied; //!< Buckets de m_table que têm entradas.
+
+            // Estado do rehash incremental: enquanto m_old_table existir, os buckets antigos
+            // com índice >= m_migrated ainda guardam suas entradas.
+            list_type *m_old_table = nullptr; //!< Tabela anterior, em migração.
+            size_type m_old_size = 0;         //!< Tamanho da tabela anterior.
+            IndexPolicy m_old_index;          //!< Mapeamento de índices da tabela anterior.
+            size_type m_migrated = 0;         //!< Buckets antigos já migrados.
+            detail::OccupancyBitmap m_old_occupied; //!< Buckets antigos ainda ocupados.
+            bool m_incremental = false;       //!< Se o rehash é feito aos poucos.
+            size_type m_rehash_step = DEFAULT_REHASH_STEP; //!< Buckets migrados por operação.
+
             static const short DEFAULT_SIZE = 10;
+            static const short DEFAULT_REHASH_STEP = 4;
+            //! Fewest buckets worth a thread of their own in a parallel rehash or copy.
+            static constexpr size_type MIN_PARALLEL_BUCKETS = size_type{1} << 14;
+            //! Upper bound on the partitions of a bulk insertion or a parallel rehash.
+            static constexpr size_type BULK_PARTITIONS = 1024;
+            //! Distance, in keys, between the stages of the batch lookup pipeline.
+            static constexpr size_type BATCH_GROUP = 16;
+            //! Lookups in flight in interleaved_find(), by default and at most.
+            static constexpr size_type DEFAULT_INTERLEAVE = 16;
+            static constexpr size_type MAX_INTERLEAVE = 64;
+            //! Iterator position past the last bucket.
+            static constexpr size_type END_POS = static_cast<size_type>(-1);
     };
 
 } // MyHashTable
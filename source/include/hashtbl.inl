@@ -2,25 +2,40 @@
 
 namespace ac
 {
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::HashTbl(size_type sz)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::HashTbl(size_type sz, const GrowthPolicy &growth, const Allocator &alloc)
+        : m_growth{growth}, m_alloc{alloc}
     {
-        m_size = sz;
-        m_table = new list_type[m_size];
+        m_size = IndexPolicy::bucket_count(sz);
+        m_index.reset(m_size);
+        m_count = 0;
+        m_table = new_buckets(m_size);
+        m_occupied.reset(occupancy_words(m_table, m_size), m_size);
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::HashTbl(const HashTbl &source)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::HashTbl(const HashTbl &source, size_type threads_)
+        : m_size{0}, m_count{0}, m_table{nullptr},
+          m_alloc{std::allocator_traits<node_allocator>::select_on_container_copy_construction(source.m_alloc)}
     {
-        m_size = source.m_size;
-        m_table = source.m_table;
+        copy_from(source, threads_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::HashTbl(HashTbl &&source) noexcept(std::is_nothrow_copy_constructible<node_allocator>::value)
+        : m_growth{source.m_growth}, m_alloc{source.m_alloc}
+    {
+        steal(source);
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::HashTbl(const std::initializer_list<entry_type> &ilist)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::HashTbl(const std::initializer_list<entry_type> &ilist)
     {
-        m_size = ilist.size();
-        m_table = new list_type[m_size];
+        m_size = IndexPolicy::bucket_count(ilist.size());
+        m_index.reset(m_size);
+        m_count = 0;
+        m_table = new_buckets(m_size);
+        m_occupied.reset(occupancy_words(m_table, m_size), m_size);
 
         for (const auto &entry : ilist)
         {
@@ -28,26 +43,55 @@ namespace ac
         }
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual> &
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const HashTbl &clone)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename InputIt, typename>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::HashTbl(InputIt first_, InputIt last_, size_type sz, const GrowthPolicy &growth, const Allocator &alloc)
+        : HashTbl(sz, growth, alloc)
+    {
+        insert_bulk(first_, last_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator> &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::operator=(const HashTbl &clone)
     {
         if (this == &clone)
             return *this;
 
-        m_size = clone.m_size;
-        m_table = clone.m_table;
+        copy_from(clone);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator> &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::operator=(HashTbl &&source) noexcept(std::is_nothrow_copy_constructible<node_allocator>::value)
+    {
+        if (this == &source)
+            return *this;
+
+        free_buckets(m_table, m_size);
+        free_buckets(m_old_table, m_old_size);
+        m_growth = source.m_growth;
+        m_alloc = source.m_alloc;
+        steal(source);
 
         return *this;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual> &
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const std::initializer_list<entry_type> &ilist)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator> &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::operator=(const std::initializer_list<entry_type> &ilist)
     {
-        m_size = ilist.size();
-        delete[] m_table; // Libera a memória alocada anteriormente
-        m_table = new list_type[m_size];
+        free_buckets(m_table, m_size); // Libera a memória alocada anteriormente
+        free_buckets(m_old_table, m_old_size);
+        m_old_table = nullptr;
+        m_size = IndexPolicy::bucket_count(ilist.size());
+        m_index.reset(m_size);
+        m_count = 0;
+        m_table = new_buckets(m_size);
+        m_occupied.reset(occupancy_words(m_table, m_size), m_size);
+        m_old_occupied.clear();
 
         for (const auto &entry : ilist)
         {
@@ -57,110 +101,703 @@ namespace ac
         return *this;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::~HashTbl()
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::~HashTbl()
     {
-        clear();
+        free_buckets(m_table, m_size);
+        free_buckets(m_old_table, m_old_size);
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert(const KeyType &key_, const DataType &new_data_)
     {
-        size_type i = KeyHash()(key_) % m_size;
-        list_type &guarda = m_table[i];
+        return insert_impl(key_, new_data_);
+    }
 
-        // Verifica se a chave já existe na lista
-        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_](const entry_type &entry)
-                                 { return KeyEqual()(entry.m_key, key_); });
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert(KeyType &&key_, DataType &&new_data_)
+    {
+        return insert_impl(std::move(key_), std::move(new_data_));
+    }
 
-        if (iter != guarda.end())
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename... Args>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::emplace(Args &&...args_)
+    {
+        rehash_step();
+
+        // Constrói o nó numa lista avulsa: a chave só existe depois de construída
+        list_type avulsa(m_alloc);
+        if constexpr (store_hash<KeyType>::value)
+            avulsa.emplace_front(size_type{0}, std::forward<Args>(args_)...);
+        else
+            avulsa.emplace_front(std::forward<Args>(args_)...);
+
+        node_type &node = avulsa.front();
+        const size_type hash = KeyHash()(node.m_key);
+        if (find_node(node.m_key, hash) != nullptr)
         {
-            return false; // A chave já existe, não pode inserir novamente
+            return false; // A chave já existe: o nó avulso é descartado
         }
+        if constexpr (store_hash<KeyType>::value)
+            node.m_hash = hash;
 
-        // Insere a nova entrada na lista
-        guarda.push_front(entry_type(key_, new_data_));
+        // Move o nó pronto para o bucket, sem cópia e sem nova alocação
+        list_type &guarda = grow_for_insert(hash);
+        guarda.splice_after(guarda.before_begin(), avulsa, avulsa.before_begin());
+        ++m_count;
 
         return true;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename... Args>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::try_emplace(const KeyType &key_, Args &&...args_)
+    {
+        return try_emplace_impl(key_, std::forward<Args>(args_)...).second;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename... Args>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::try_emplace(KeyType &&key_, Args &&...args_)
+    {
+        return try_emplace_impl(std::move(key_), std::forward<Args>(args_)...).second;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename M>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_or_assign(const KeyType &key_, M &&obj_)
+    {
+        return insert_impl(key_, std::forward<M>(obj_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename M>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_or_assign(KeyType &&key_, M &&obj_)
+    {
+        return insert_impl(std::move(key_), std::forward<M>(obj_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::clear()
     {
         for (size_type i = 0; i < m_size; ++i)
         {
             m_table[i].clear();
         }
+        free_buckets(m_old_table, m_old_size); // Uma migração em curso não tem mais o que mover
+        m_old_table = nullptr;
+        m_occupied.reset();
+        m_old_occupied.clear();
         m_count = 0;
+
+        // Sem nenhum nó vivo, um alocador de pool devolve seus blocos de uma vez
+        if constexpr (detail::has_release<node_allocator>::value)
+        {
+            m_alloc.release();
+        }
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::empty() const
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::empty() const
     {
-        for (size_type i = 0; i < m_size; ++i)
+        return m_count == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename InputIt, typename>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_bulk(InputIt first_, InputIt last_, bool keys_unique_, size_type threads_)
+    {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        size_type inserted = 0;
+
+        if constexpr (!std::is_base_of<std::forward_iterator_tag, category>::value)
         {
-            if (!m_table[i].empty())
+            // Iteradores de uma passada só não podem ser contados antes: insere um a um
+            for (; first_ != last_; ++first_)
             {
-                return false;
+                inserted += insert_impl(detail::key_of(*first_), detail::data_of(*first_));
             }
+            return inserted;
+        }
+        else
+        {
+            using value_type = typename std::iterator_traits<InputIt>::value_type;
+            struct Item {
+                const value_type *src; // Elemento de origem
+                size_type hash;
+                size_type bucket;
+            };
+
+            const auto n = static_cast<size_type>(std::distance(first_, last_));
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            // Dimensiona a tabela uma vez só, supondo que nenhuma chave se repete; as entradas já
+            // presentes mudam de bucket com as mesmas threads
+            const size_type needed = m_growth.buckets_for(m_count + n);
+            if (needed > m_size)
+            {
+                resize(needed, threads_);
+            }
+            finish_rehash();
+
+            std::vector<Item> items(n);
+            for (size_type i = 0; i < n; ++i, ++first_)
+            {
+                items[i].src = &*first_;
+            }
+
+            // Partições são faixas contíguas de buckets
+            const size_type parts = std::min<size_type>(BULK_PARTITIONS, m_size);
+            const size_type buckets = m_size;
+            auto part_of = [parts, buckets](size_type bucket) { return bucket * parts / buckets; };
+
+            if (threads_ == 0)
+            {
+                threads_ = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+            }
+            const size_type workers = std::min(threads_, n);
+            const size_type slice = (n + workers - 1) / workers;
+
+            // Cada thread calcula os hashes da sua fatia e conta quantos itens vão para cada partição
+            std::vector<size_type> counts(workers * parts, 0);
+            auto hash_slice = [&](size_type w)
+            {
+                size_type *hist = &counts[w * parts];
+                for (size_type i = w * slice; i < std::min(n, (w + 1) * slice); ++i)
+                {
+                    items[i].hash = KeyHash()(detail::key_of(*items[i].src));
+                    items[i].bucket = m_index.index(items[i].hash);
+                    ++hist[part_of(items[i].bucket)];
+                }
+            };
+
+            // Soma de prefixos: a fatia w escreve na partição p logo depois das fatias anteriores,
+            // o que mantém a ordem de entrada dentro de cada partição
+            std::vector<Item> sorted(n);
+            auto scatter_slice = [&](size_type w)
+            {
+                size_type *next = &counts[w * parts];
+                for (size_type i = w * slice; i < std::min(n, (w + 1) * slice); ++i)
+                {
+                    sorted[next[part_of(items[i].bucket)]++] = items[i];
+                }
+            };
+
+            run_workers(workers, hash_slice);
+            size_type offset = 0;
+            for (size_type p = 0; p < parts; ++p)
+            {
+                for (size_type w = 0; w < workers; ++w)
+                {
+                    const size_type count = counts[w * parts + p];
+                    counts[w * parts + p] = offset;
+                    offset += count;
+                }
+            }
+            run_workers(workers, scatter_slice);
+
+            // Inserção, partição por partição: as escritas ficam numa faixa pequena da tabela
+            for (const Item &item : sorted)
+            {
+                list_type &guarda = m_table[item.bucket];
+                const auto &key = detail::key_of(*item.src);
+
+                if (!keys_unique_)
+                {
+                    auto node = std::find_if(guarda.begin(), guarda.end(), [&key, &item](const node_type &entry)
+                                             { return matches(entry, key, item.hash); });
+                    if (node != guarda.end())
+                    {
+                        node->m_data = detail::data_of(*item.src); // A última ocorrência vence
+                        continue;
+                    }
+                }
+                assert(find_node(key, item.hash) == nullptr && "insert_bulk: keys_unique_ with a repeated key");
+
+                emplace_node(guarda, item.hash, std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(detail::data_of(*item.src)));
+                m_occupied.set(item.bucket);
+                ++inserted;
+            }
+            return inserted;
         }
-        return true;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::retrieve(const KeyType &key_, DataType &data_item_) const
     {
-        size_type i = KeyHash()(key_) % m_size;
-        const list_type &guarda = m_table[i];
+        const DataType *data = find_ptr(key_);
 
-        // Procura pela chave na lista
-        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_](const entry_type &entry)
-                                 { return KeyEqual()(entry.m_key, key_); });
-
-        if (iter != guarda.end())
+        if (data != nullptr)
         {
-            data_item_ = iter->m_data; // Armazena o dado encontrado na variável de saída
-            return true;               // A chave foi encontrada
+            data_item_ = *data; // Armazena o dado encontrado na variável de saída
+            return true;        // A chave foi encontrada
         }
 
         return false; // A chave não foi encontrada
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::rehash(void)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::retrieve(const K &key_, DataType &data_item_) const
     {
-        size_type new_table_size = find_next_prime(m_size * 2);
-        list_type *new_table = new list_type[new_table_size];
+        const DataType *data = find_ptr(key_);
 
-        for (size_type i = 0; i < m_size; ++i)
+        if (data != nullptr)
         {
-            for (const auto &entry : m_table[i])
-            {
-                size_type new_index = KeyHash()(entry.m_key) % new_table_size;
-                new_table[new_index].push_front(entry);
-            }
+            data_item_ = *data;
+            return true;
         }
 
-        delete[] m_table;
-        m_table = new_table;
-        m_size = new_table_size;
+        return false;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::rehash(size_type n_, size_type threads_)
+    {
+        resize(std::max(n_, m_growth.buckets_for(m_count)), threads_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::reserve(size_type n_)
+    {
+        const size_type needed = m_growth.buckets_for(n_);
+        if (needed > m_size)
+        {
+            resize(needed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    float HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::max_load_factor() const
+    {
+        return m_growth.max_load_factor();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::max_load_factor(float mlf)
+    {
+        m_growth.max_load_factor(mlf);
+
+        // Um limite menor pode exigir crescer imediatamente
+        const size_type target = m_growth.grow_to(m_count, m_size);
+        if (target != 0)
+        {
+            resize(target);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    float HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::load_factor() const
+    {
+        return m_size != 0 ? static_cast<float>(m_count) / m_size : 0.0f;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::erase(const KeyType &key_)
+    {
+        return erase_node(key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::erase(const K &key_)
+    {
+        return erase_node(key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::count(const KeyType &key_) const
+    {
+        const list_type &guarda = bucket_of(KeyHash()(key_));
+
+        // Retorna o número de entradas que colidem no mesmo bucket da chave
+        return std::distance(guarda.begin(), guarda.end());
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::count(const K &key_) const
+    {
+        const list_type &guarda = bucket_of(KeyHash()(key_));
+        return std::distance(guarda.begin(), guarda.end());
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::at(const KeyType &key_)
+    {
+        rehash_step();
+        DataType *data = find_ptr(key_);
+
+        if (data != nullptr)
+        {
+            return *data; // Retorna uma referência para o dado encontrado
+        }
+
+        throw std::out_of_range("Key not found in HashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::at(const K &key_)
+    {
+        rehash_step();
+        DataType *data = find_ptr(key_);
+
+        if (data != nullptr)
+        {
+            return *data;
+        }
+
+        throw std::out_of_range("Key not found in HashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::operator[](const KeyType &key_)
+    {
+        // Se a chave não existe, insere uma entrada com um valor padrão para o dado
+        return try_emplace_impl(key_).first->m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::operator[](KeyType &&key_)
+    {
+        return try_emplace_impl(std::move(key_)).first->m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find(const KeyType &key_)
+    {
+        return find_in(*this, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    DataType *HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_ptr(const KeyType &key_)
+    {
+        const auto node = find_in(*this, key_);
+        return node != end() ? &node->m_data : nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find(const KeyType &key_) const
+    {
+        return find_in(*this, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    const DataType *HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_ptr(const KeyType &key_) const
+    {
+        const auto node = find_in(*this, key_);
+        return node != end() ? &node->m_data : nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find(const K &key_)
+    {
+        return find_in(*this, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    DataType *HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_ptr(const K &key_)
+    {
+        const auto node = find_in(*this, key_);
+        return node != end() ? &node->m_data : nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find(const K &key_) const
+    {
+        return find_in(*this, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    const DataType *HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_ptr(const K &key_) const
+    {
+        const auto node = find_in(*this, key_);
+        return node != end() ? &node->m_data : nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::contains(const KeyType &key_) const
+    {
+        return find_in(*this, key_) != end();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::contains(const K &key_) const
+    {
+        return find_in(*this, key_) != end();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::retrieve_batch(span<const KeyType> keys_, span<DataType *> out_)
+    {
+        if (out_.size() < keys_.size())
+        {
+            throw std::length_error("retrieve_batch: output span shorter than the keys");
+        }
+
+        return lookup_batch(*this, keys_, [&out_](size_type i, node_type *node)
+                            { out_[i] = node != nullptr ? &node->m_data : nullptr; });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::retrieve_batch(span<const KeyType> keys_, span<const DataType *> out_) const
+    {
+        if (out_.size() < keys_.size())
+        {
+            throw std::length_error("retrieve_batch: output span shorter than the keys");
+        }
+
+        return lookup_batch(*this, keys_, [&out_](size_type i, const node_type *node)
+                            { out_[i] = node != nullptr ? &node->m_data : nullptr; });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::count_batch(span<const KeyType> keys_) const
+    {
+        return lookup_batch(*this, keys_, [](size_type, const node_type *) {});
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::interleaved_find(span<const KeyType> keys_, span<DataType *> out_, size_type width_)
+    {
+        if (out_.size() < keys_.size())
+        {
+            throw std::length_error("interleaved_find: output span shorter than the keys");
+        }
+
+        return lookup_interleaved(*this, keys_, width_, [&out_](size_type i, node_type *node)
+                                  { out_[i] = node != nullptr ? &node->m_data : nullptr; });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::interleaved_find(span<const KeyType> keys_, span<const DataType *> out_, size_type width_) const
+    {
+        if (out_.size() < keys_.size())
+        {
+            throw std::length_error("interleaved_find: output span shorter than the keys");
+        }
+
+        return lookup_interleaved(*this, keys_, width_, [&out_](size_type i, const node_type *node)
+                                  { out_[i] = node != nullptr ? &node->m_data : nullptr; });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::begin()
+    {
+        return first_from(*this, 0);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::begin() const
+    {
+        return first_from(*this, 0);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::cbegin() const
+    {
+        return begin();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::end()
+    {
+        return iterator(this, END_POS, typename list_type::iterator());
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::end() const
+    {
+        return const_iterator(this, END_POS, typename list_type::const_iterator());
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::const_iterator
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::cend() const
+    {
+        return end();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket(const KeyType &key_) const
+    {
+        return m_index.index(KeyHash()(key_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_size(size_type n_) const
+    {
+        return std::distance(m_table[n_].begin(), m_table[n_].end());
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::incremental_rehash() const
+    {
+        return m_incremental;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::incremental_rehash(bool enable_, size_type buckets_per_step_)
+    {
+        if (!enable_)
+        {
+            finish_rehash();
+        }
+        m_incremental = enable_;
+        m_rehash_step = buckets_per_step_ > 0 ? buckets_per_step_ : 1;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::hash_of(const node_type &entry)
+    {
+        // Com o hash guardado, o rehash não chama KeyHash de novo
+        if constexpr (store_hash<KeyType>::value)
+            return entry.m_hash;
+        else
+            return KeyHash()(entry.m_key);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::matches(const node_type &entry, const K &key_, size_type hash)
+    {
+        // Compara os hashes primeiro: chaves diferentes quase nunca chegam ao KeyEqual
+        if constexpr (store_hash<KeyType>::value)
+            return entry.m_hash == hash && KeyEqual()(entry.m_key, key_);
+        else
+            return KeyEqual()(entry.m_key, key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename... Args>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::node_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::emplace_node(list_type &bucket_, size_type hash, Args &&...args_)
+    {
+        if constexpr (store_hash<KeyType>::value)
+            bucket_.emplace_front(hash, std::forward<Args>(args_)...);
+        else
+            bucket_.emplace_front(std::forward<Args>(args_)...);
+        ++m_count;
+
+        return bucket_.front();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename D>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::insert_impl(K &&key_, D &&data_)
+    {
+        rehash_step();
+        const size_type hash = KeyHash()(key_);
+
+        // Verifica se a chave já existe na lista
+        if (node_type *node = find_node(key_, hash))
+        {
+            node->m_data = std::forward<D>(data_); // A chave já existe: apenas atualiza o dado
+            return false;
+        }
+
+        // Chave e dado são construídos direto no nó
+        emplace_node(grow_for_insert(hash), hash, std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key_)), std::forward_as_tuple(std::forward<D>(data_)));
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K, typename... Args>
+    std::pair<typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::node_type *, bool>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::try_emplace_impl(K &&key_, Args &&...args_)
     {
-        size_type i = KeyHash()(key_) % m_size;
-        list_type &guarda = m_table[i];
+        rehash_step();
+        const size_type hash = KeyHash()(key_);
+
+        if (node_type *node = find_node(key_, hash))
+        {
+            return {node, false};
+        }
+
+        node_type &node = emplace_node(grow_for_insert(hash), hash, std::piecewise_construct,
+                                       std::forward_as_tuple(std::forward<K>(key_)),
+                                       std::forward_as_tuple(std::forward<Args>(args_)...));
+        return {&node, true};
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::node_type *
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_node(const K &key_, size_type hash)
+    {
+        return const_cast<node_type *>(static_cast<const HashTbl &>(*this).find_node(key_, hash));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K>
+    const typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::node_type *
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_node(const K &key_, size_type hash) const
+    {
+        const list_type &guarda = bucket_of(hash);
+
+        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_, hash](const node_type &entry)
+                                 { return matches(entry, key_, hash); });
+
+        return iter != guarda.end() ? &*iter : nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename K>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::erase_node(const K &key_)
+    {
+        rehash_step();
+        const size_type hash = KeyHash()(key_);
+        const size_type pos = locate(hash);
+        list_type &guarda = bucket_at(pos);
 
         auto prev = guarda.before_begin();
         auto curr = guarda.begin();
 
         while (curr != guarda.end())
         {
-            if (KeyEqual()(curr->m_key, key_))
+            if (matches(*curr, key_, hash))
             {
                 guarda.erase_after(prev);
                 --m_count;
+                if (guarda.empty())
+                {
+                    mark_occupied(pos, false);
+                }
+                shrink_after_erase();
                 return true;
             }
             ++prev;
@@ -170,89 +807,667 @@ namespace ac
         return false;
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    std::size_t HashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_next_prime(size_type n_)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::steal(HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator> &source)
     {
-        if (n_ <= 2)
-            return 2;
+        m_size = source.m_size;
+        m_count = source.m_count;
+        m_table = source.m_table;
+        m_index = source.m_index;
+        m_old_table = source.m_old_table;
+        m_old_size = source.m_old_size;
+        m_old_index = source.m_old_index;
+        m_migrated = source.m_migrated;
+        m_incremental = source.m_incremental;
+        m_rehash_step = source.m_rehash_step;
+        m_occupied = std::move(source.m_occupied);
+        m_old_occupied = std::move(source.m_old_occupied);
 
-        bool prime = false;
-        size_type next_prime = n_;
+        // A origem fica vazia e sem buckets; o próximo insert a faz crescer de novo. Ela mantém
+        // uma cópia do seu alocador: trocá-lo por um novo poderia lançar exceção
+        source.m_size = 0;
+        source.m_count = 0;
+        source.m_table = nullptr;
+        source.m_old_table = nullptr;
+        source.m_old_size = 0;
+        source.m_migrated = 0;
+        source.m_occupied.clear();
+        source.m_old_occupied.clear();
+    }
 
-        while (!prime)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type *
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::new_buckets(size_type n_)
+    {
+        // Um só bloco: as cabeças das listas e, logo depois, as palavras do bitmap de ocupação
+        void *block = ::operator new(words_offset(n_) + detail::OccupancyBitmap::words_for(n_) * sizeof(std::uint64_t));
+        list_type *buckets = static_cast<list_type *>(block);
+
+        // Todas as listas precisam compartilhar o alocador da tabela (e o seu pool)
+        for (size_type i = 0; i < n_; ++i)
         {
-            ++next_prime;
-            prime = true;
+            ::new (static_cast<void *>(buckets + i)) list_type(m_alloc);
+        }
+        return buckets;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::free_buckets(list_type *buckets_, size_type n_)
+    {
+        if (buckets_ == nullptr)
+            return;
+
+        for (size_type i = 0; i < n_; ++i)
+        {
+            buckets_[i].~list_type();
+        }
+        ::operator delete(static_cast<void *>(buckets_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::words_offset(size_type n_)
+    {
+        // As palavras começam no primeiro endereço alinhado após a última lista
+        constexpr size_type align = alignof(std::uint64_t);
+        return (n_ * sizeof(list_type) + align - 1) / align * align;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    std::uint64_t *HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::occupancy_words(list_type *buckets_, size_type n_)
+    {
+        return reinterpret_cast<std::uint64_t *>(reinterpret_cast<unsigned char *>(buckets_) + words_offset(n_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Table, typename K>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::template Iterator<std::is_const<Table>::value>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::find_in(Table &table_, const K &key_)
+    {
+        using iter_type = Iterator<std::is_const<Table>::value>;
 
-            for (size_type i = 2; i <= std::sqrt(next_prime); ++i)
+        const size_type hash = KeyHash()(key_);
+        const size_type pos = table_.locate(hash);
+        auto &guarda = table_.bucket_at(pos);
+
+        // Procura pela chave na lista, sem copiar nada
+        auto node = std::find_if(guarda.begin(), guarda.end(), [&key_, hash](const node_type &entry)
+                                 { return matches(entry, key_, hash); });
+
+        return node != guarda.end() ? iter_type(&table_, pos, node) : table_.end();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Table>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::template Iterator<std::is_const<Table>::value>
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::first_from(Table &table_, size_type pos)
+    {
+        using iter_type = Iterator<std::is_const<Table>::value>;
+
+        // Um bit ligado pode apontar para um bucket vazio (ver grow_for_insert)
+        for (pos = table_.next_occupied(pos); pos != END_POS; pos = table_.next_occupied(pos + 1))
+        {
+            auto &guarda = table_.bucket_at(pos);
+            if (!guarda.empty())
+            {
+                return iter_type(&table_, pos, guarda.begin());
+            }
+        }
+
+        return table_.end();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Table, typename Visit>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::lookup_batch(Table &table_, span<const KeyType> keys_, Visit visit_)
+    {
+        using list_ptr = decltype(&table_.bucket_at(0));
+
+        // Pipeline em três estágios, BATCH_GROUP chaves de distância entre eles: a chave j tem
+        // o hash calculado e a cabeça do bucket pedida na volta j, o primeiro nó pedido na
+        // volta j + BATCH_GROUP e é comparada na volta j + 2 * BATCH_GROUP
+        constexpr size_type ring = 2 * BATCH_GROUP;
+        size_type hashes[ring];
+        list_ptr heads[ring];
+        size_type hits = 0;
+        const size_type n = keys_.size();
+
+        for (size_type t = 0; t < n + ring; ++t)
+        {
+            // Compara antes de o estágio do hash reaproveitar a mesma posição do anel
+            if (t >= ring)
+            {
+                const size_type j = t - ring;
+                const KeyType &key = keys_[j];
+                const size_type hash = hashes[j % ring];
+                auto &guarda = *heads[j % ring];
+                auto node = std::find_if(guarda.begin(), guarda.end(), [&key, hash](const node_type &entry)
+                                         { return matches(entry, key, hash); });
+
+                if (node != guarda.end())
+                {
+                    ++hits;
+                    visit_(j, &*node);
+                }
+                else
+                {
+                    visit_(j, nullptr);
+                }
+            }
+
+            // A cabeça já deve ter chegado: pede o primeiro nó da lista
+            if (t >= BATCH_GROUP && t - BATCH_GROUP < n)
+            {
+                const list_type &guarda = *heads[(t - BATCH_GROUP) % ring];
+                if (!guarda.empty())
+                {
+                    detail::prefetch(&guarda.front());
+                }
+            }
+
+            if (t < n)
             {
-                if (next_prime % i == 0)
+                hashes[t % ring] = KeyHash()(keys_[t]);
+                heads[t % ring] = &table_.bucket_of(hashes[t % ring]);
+                detail::prefetch(heads[t % ring]);
+            }
+        }
+
+        return hits;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Table, typename Visit>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::lookup_interleaved(Table &table_, span<const KeyType> keys_, size_type width_, Visit visit_)
+    {
+        using list_ptr = decltype(&table_.bucket_at(0));
+        using node_iter = decltype(table_.bucket_at(0).begin());
+        using node_ptr = decltype(&*std::declval<node_iter>());
+
+        // Cada busca em andamento é uma máquina de estados que para logo depois de cada prefetch
+        enum class Stage { idle, head, node };
+        struct Lane {
+            Stage stage = Stage::idle;
+            size_type key = 0;  // Índice da chave em keys_
+            size_type hash = 0;
+            list_ptr head = nullptr;
+            node_iter node{};
+        };
+
+        Lane lanes[MAX_INTERLEAVE];
+        const size_type width = std::min(std::max<size_type>(width_, 1), MAX_INTERLEAVE);
+        const size_type n = keys_.size();
+        size_type next_key = 0;
+        size_type hits = 0;
+        size_type active = 0;
+
+        // Uma faixa livre pega a próxima chave, calcula o hash e pede a cabeça do bucket
+        auto start = [&](Lane &lane)
+        {
+            if (next_key == n)
+            {
+                lane.stage = Stage::idle;
+                return;
+            }
+            lane.key = next_key++;
+            lane.hash = KeyHash()(keys_[lane.key]);
+            lane.head = &table_.bucket_of(lane.hash);
+            detail::prefetch(lane.head);
+            lane.stage = Stage::head;
+        };
+        auto finish = [&](Lane &lane, node_ptr found)
+        {
+            hits += found != nullptr;
+            visit_(lane.key, found);
+            start(lane);
+            active -= lane.stage == Stage::idle;
+        };
+
+        for (size_type i = 0; i < width; ++i)
+        {
+            start(lanes[i]);
+            active += lanes[i].stage != Stage::idle;
+        }
+
+        // Escalonador round-robin: cada faixa avança um passo e cede a vez à seguinte
+        while (active > 0)
+        {
+            for (size_type i = 0; i < width; ++i)
+            {
+                Lane &lane = lanes[i];
+                switch (lane.stage)
                 {
-                    prime = false;
+                case Stage::idle:
+                    break;
+                case Stage::head:
+                    lane.node = lane.head->begin();
+                    if (lane.node == lane.head->end())
+                    {
+                        finish(lane, nullptr);
+                        break;
+                    }
+                    detail::prefetch(&*lane.node);
+                    lane.stage = Stage::node;
+                    break;
+                case Stage::node:
+                    if (matches(*lane.node, keys_[lane.key], lane.hash))
+                    {
+                        finish(lane, &*lane.node);
+                        break;
+                    }
+                    if (++lane.node == lane.head->end())
+                    {
+                        finish(lane, nullptr);
+                        break;
+                    }
+                    detail::prefetch(&*lane.node);
                     break;
                 }
             }
         }
 
-        return next_prime;
+        return hits;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::next_occupied(size_type pos) const
+    {
+        // Primeiro os buckets da tabela nova, depois os antigos ainda não migrados
+        if (pos < m_size)
+        {
+            const size_type next = m_occupied.next(pos);
+            if (next != detail::OccupancyBitmap::npos && next < m_size)
+            {
+                return next;
+            }
+            pos = m_size;
+        }
+        if (m_old_table != nullptr)
+        {
+            const size_type next = m_old_occupied.next(pos - m_size);
+            if (next != detail::OccupancyBitmap::npos && next < m_old_size)
+            {
+                return m_size + next;
+            }
+        }
+
+        return END_POS;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::mark_occupied(size_type pos, bool occupied_)
+    {
+        detail::OccupancyBitmap &bits = pos < m_size ? m_occupied : m_old_occupied;
+        const size_type index = pos < m_size ? pos : pos - m_size;
+
+        if (occupied_)
+            bits.set(index);
+        else
+            bits.unset(index);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::rebuild_occupied()
+    {
+        m_occupied.reset(occupancy_words(m_table, m_size), m_size);
+        for (size_type i = 0; i < m_size; ++i)
+        {
+            if (!m_table[i].empty())
+            {
+                m_occupied.set(i);
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    template <typename Fn>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::run_workers(size_type workers_, Fn fn_)
+    {
+        // A primeira exceção de qualquer fatia volta ao chamador, depois que todas terminarem
+        std::exception_ptr error;
+        std::mutex error_lock;
+        auto worker = [&fn_, &error, &error_lock](size_type w)
+        {
+            try
+            {
+                fn_(w);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        // A thread chamadora faz a fatia 0; as demais ganham uma thread cada. As threads são
+        // juntadas mesmo se a criação de uma delas falhar
+        struct Joiner {
+            std::vector<std::thread> pool;
+            ~Joiner()
+            {
+                for (auto &t : pool)
+                {
+                    t.join();
+                }
+            }
+        } joiner;
+        joiner.pool.reserve(workers_ - 1);
+        for (size_type w = 1; w < workers_; ++w)
+        {
+            joiner.pool.emplace_back(worker, w);
+        }
+        worker(0);
+        for (auto &t : joiner.pool)
+        {
+            t.join();
+        }
+        joiner.pool.clear();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
-    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::workers_for(size_type threads_, size_type buckets_)
     {
-        size_type i = KeyHash()(key_) % m_size;
-        const list_type &guarda = m_table[i];
+        if (threads_ == 0)
+        {
+            threads_ = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+        }
+        return std::max<size_type>(std::min(threads_, buckets_ / MIN_PARALLEL_BUCKETS), 1);
+    }
 
-        // Verifica se a chave está presente na lista
-        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_](const entry_type &entry)
-                                 { return KeyEqual()(entry.m_key, key_); });
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::locate(size_type hash) const
+    {
+        // Uma tabela movida não tem buckets: toda busca cai numa lista vazia
+        if (m_size == 0)
+        {
+            return END_POS;
+        }
 
-        if (iter != guarda.end())
+        // Durante uma migração, buckets antigos ainda não migrados continuam valendo.
+        // Posições [0, m_size) são da tabela nova; a partir de m_size, da antiga.
+        if (m_old_table != nullptr)
         {
-            return 1; // A chave foi encontrada, retorna 1
+            const size_type old_index = m_old_index.index(hash);
+            if (old_index >= m_migrated)
+            {
+                return m_size + old_index;
+            }
         }
 
-        return 0; // A chave não foi encontrada, retorna 0
+        return m_index.index(hash);
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_at(size_type pos)
     {
-        size_type i = KeyHash()(key_) % m_size;
-        list_type &guarda = m_table[i];
+        return const_cast<list_type &>(static_cast<const HashTbl &>(*this).bucket_at(pos));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    const typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_at(size_type pos) const
+    {
+        if (pos < m_size)
+        {
+            return m_table[pos];
+        }
+        if (m_old_table != nullptr && pos - m_size < m_old_size)
+        {
+            return m_old_table[pos - m_size];
+        }
 
-        // Procura pela chave na lista
-        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_](const entry_type &entry)
-                                 { return KeyEqual()(entry.m_key, key_); });
+        static const list_type nenhum;
+        return nenhum;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_of(size_type hash)
+    {
+        return bucket_at(locate(hash));
+    }
 
-        if (iter != guarda.end())
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    const typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::bucket_of(size_type hash) const
+    {
+        return bucket_at(locate(hash));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::list_type &
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::grow_for_insert(size_type hash)
+    {
+        const size_type target = m_growth.grow_to(m_count + 1, m_size);
+        if (target != 0)
         {
-            return iter->m_data; // Retorna uma referência para o dado encontrado
+            resize(target);
         }
 
-        throw std::out_of_range("Key not found in HashTbl");
+        // O chamador insere neste bucket; se a construção falhar, o bit fica ligado à toa,
+        // e a iteração apenas pula o bucket vazio
+        const size_type pos = locate(hash);
+        mark_occupied(pos, true);
+        return bucket_at(pos);
     }
 
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::shrink_after_erase()
     {
-        size_type i = KeyHash()(key_) % m_size;
-        list_type &guarda = m_table[i];
+        // Nunca encolhe abaixo do tamanho padrão: tabelas minúsculas voltariam a crescer logo
+        const size_type target = m_growth.shrink_to(m_count, m_size);
+        if (target != 0)
+        {
+            resize(std::max<size_type>(target, DEFAULT_SIZE));
+        }
+    }
 
-        // Procura pela chave na lista
-        auto iter = std::find_if(guarda.begin(), guarda.end(), [&key_](const entry_type &entry)
-                                 { return KeyEqual()(entry.m_key, key_); });
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::resize(size_type buckets_, size_type threads_)
+    {
+        // Uma migração anterior precisa terminar antes de outra começar
+        finish_rehash();
 
-        if (iter != guarda.end())
+        size_type new_table_size = IndexPolicy::bucket_count(buckets_);
+        if (new_table_size == m_size)
         {
-            return iter->m_data; // Retorna uma referência para o dado encontrado
+            return;
         }
 
-        // Insere uma nova entrada com a chave e um valor padrão para o dado
-        guarda.push_front(entry_type(key_, DataType()));
-        ++m_count;
+        list_type *new_table = new_buckets(new_table_size);
+        IndexPolicy new_index_policy;
+        new_index_policy.reset(new_table_size);
+
+        if (m_incremental)
+        {
+            // As duas tabelas ficam vivas; os buckets antigos migram aos poucos em rehash_step()
+            m_old_table = m_table;
+            m_old_size = m_size;
+            m_old_index = m_index;
+            m_migrated = 0;
+            m_old_occupied = std::move(m_occupied);
+        }
+        else
+        {
+            const size_type workers = workers_for(threads_, std::max(m_size, new_table_size));
+            if (workers > 1)
+            {
+                move_parallel(new_table, new_table_size, new_index_policy, workers);
+            }
+            else
+            {
+                // Religa cada nó na lista nova: nenhuma alocação, nenhuma cópia de entrada
+                for (size_type i = 0; i < m_size; ++i)
+                {
+                    list_type &velha = m_table[i];
+                    while (!velha.empty())
+                    {
+                        list_type &guarda = new_table[new_index_policy.index(hash_of(velha.front()))];
+                        guarda.splice_after(guarda.before_begin(), velha, velha.before_begin());
+                    }
+                }
+            }
+            free_buckets(m_table, m_size); // Só cabeças de listas vazias
+        }
+
+        m_table = new_table;
+        m_size = new_table_size;
+        m_index = new_index_policy;
+        rebuild_occupied();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::move_parallel(list_type *to_, size_type to_size_, const IndexPolicy &to_index_, size_type workers_)
+    {
+        // Partições são faixas contíguas de buckets novos, como em insert_bulk()
+        const size_type parts = std::min<size_type>(BULK_PARTITIONS, to_size_);
+        auto part_of = [parts, to_size_](size_type bucket) { return bucket * parts / to_size_; };
+        const size_type slice = (m_size + workers_ - 1) / workers_;
+
+        // Separação: cada thread desliga os nós da sua fatia de buckets antigos e os religa, na
+        // ordem em que aparecem, numa lista própria por partição
+        std::vector<list_type> staged;
+        staged.reserve(workers_ * parts);
+        for (size_type k = 0; k < workers_ * parts; ++k)
+        {
+            staged.emplace_back(m_alloc);
+        }
+        run_workers(workers_, [&](size_type w)
+                    {
+                        list_type *mine = &staged[w * parts];
+                        std::vector<typename list_type::iterator> tail(parts);
+                        for (size_type p = 0; p < parts; ++p)
+                        {
+                            tail[p] = mine[p].before_begin();
+                        }
+                        for (size_type i = w * slice; i < std::min(m_size, (w + 1) * slice); ++i)
+                        {
+                            list_type &velha = m_table[i];
+                            while (!velha.empty())
+                            {
+                                const size_type p = part_of(to_index_.index(hash_of(velha.front())));
+                                mine[p].splice_after(tail[p], velha, velha.before_begin());
+                                ++tail[p];
+                            }
+                        }
+                    });
+
+        // Posicionamento: cada thread é dona de uma faixa de partições e só escreve nas suas listas.
+        // As fatias são lidas em ordem, o que dá às cadeias a ordem do rehash serial; o hash é
+        // pedido de novo, o que nada custa quando a entrada o guarda
+        run_workers(workers_, [&](size_type w)
+                    {
+                        for (size_type p = w * parts / workers_; p < (w + 1) * parts / workers_; ++p)
+                        {
+                            for (size_type from = 0; from < workers_; ++from)
+                            {
+                                list_type &fila = staged[from * parts + p];
+                                while (!fila.empty())
+                                {
+                                    list_type &guarda = to_[to_index_.index(hash_of(fila.front()))];
+                                    guarda.splice_after(guarda.before_begin(), fila, fila.before_begin());
+                                }
+                            }
+                        }
+                    });
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::rehash_step()
+    {
+        if (m_old_table == nullptr)
+            return;
 
-        return guarda.front().m_data;
+        // Religa os nós de um número fixo de buckets antigos na tabela nova
+        for (size_type n = 0; n < m_rehash_step && m_migrated < m_old_size; ++n, ++m_migrated)
+        {
+            list_type &velha = m_old_table[m_migrated];
+            while (!velha.empty())
+            {
+                const size_type index = m_index.index(hash_of(velha.front()));
+                m_table[index].splice_after(m_table[index].before_begin(), velha, velha.before_begin());
+                m_occupied.set(index);
+            }
+            m_old_occupied.unset(m_migrated);
+        }
+
+        if (m_migrated == m_old_size)
+        {
+            free_buckets(m_old_table, m_old_size);
+            m_old_table = nullptr;
+            m_old_occupied.clear();
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::finish_rehash()
+    {
+        while (m_old_table != nullptr)
+        {
+            rehash_step();
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy, typename Allocator>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy, Allocator>::copy_from(const HashTbl &source, size_type threads_)
+    {
+        // Se uma cópia lançar exceção, o bloco e os nós já copiados são liberados; a tabela fica como estava
+        struct BucketsGuard {
+            list_type *table;
+            size_type size;
+            ~BucketsGuard() { free_buckets(table, size); }
+        } guard{new_buckets(source.m_size), source.m_size};
+        list_type *new_table = guard.table;
+
+        // Copia cada lista, para que as tabelas não compartilhem memória; cada thread copia uma
+        // fatia de buckets e nenhuma lista é escrita por duas
+        // As threads alocam nós ao mesmo tempo: só alocadores sem estado (o heap global) aguentam
+        const size_type workers = std::allocator_traits<node_allocator>::is_always_equal::value
+                                      ? workers_for(threads_, source.m_size) : 1;
+        const size_type slice = (source.m_size + workers - 1) / workers;
+        run_workers(workers, [&](size_type w)
+                    {
+                        for (size_type i = w * slice; i < std::min(source.m_size, (w + 1) * slice); ++i)
+                        {
+                            new_table[i].assign(source.m_table[i].begin(), source.m_table[i].end());
+                        }
+                    });
+
+        // Entradas da origem que ainda não migraram vão direto para a tabela nova
+        for (size_type i = source.m_migrated; source.m_old_table != nullptr && i < source.m_old_size; ++i)
+        {
+            for (const auto &entry : source.m_old_table[i])
+            {
+                new_table[source.m_index.index(hash_of(entry))].push_front(entry);
+            }
+        }
+
+        guard.table = nullptr;
+        free_buckets(m_table, m_size);
+        free_buckets(m_old_table, m_old_size);
+        m_table = new_table;
+        m_old_table = nullptr;
+        m_size = source.m_size;
+        m_index = source.m_index;
+        m_count = source.m_count;
+        m_growth = source.m_growth;
+        m_incremental = source.m_incremental;
+        m_rehash_step = source.m_rehash_step;
+        m_old_occupied.clear();
+        rebuild_occupied();
     }
 } // Namespace ac.
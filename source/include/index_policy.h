@@ -0,0 +1,126 @@
+#ifndef INDEX_POLICY_H
+#define INDEX_POLICY_H
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <limits>   // std::numeric_limits
+
+#include "prime_ladder.h"
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        /// Returns the smallest power of two that is not less than `n_` (at least 2). Like the
+        /// prime ladder at its top rung, it saturates: past 2^63 it returns 2^63.
+        inline std::size_t next_power_of_two( std::size_t n_ )
+        {
+            constexpr std::size_t top = std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1);
+            if (n_ >= top)
+                return top;
+            std::size_t size = 2;
+            while (size < n_)
+                size <<= 1;
+            return size;
+        }
+
+        /// Upper 64 bits of the 128-bit product `a_ * b_`.
+        inline std::uint64_t mul_high( std::uint64_t a_, std::uint64_t b_ )
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<std::uint64_t>( (static_cast<unsigned __int128>( a_ ) * b_) >> 64 );
+#else
+            const std::uint64_t a_lo = a_ & 0xFFFFFFFFu, a_hi = a_ >> 32;
+            const std::uint64_t b_lo = b_ & 0xFFFFFFFFu, b_hi = b_ >> 32;
+            const std::uint64_t lo_lo = a_lo * b_lo;
+            const std::uint64_t hi_lo = a_hi * b_lo;
+            const std::uint64_t lo_hi = a_lo * b_hi;
+            const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+        }
+    } // namespace detail
+
+    // An index policy maps a hash value to a bucket of the chained table. Every policy offers:
+    //   static size_type bucket_count( n ) -> the first valid bucket count for a request of `n`;
+    //   void reset( size )                 -> precomputes whatever `index()` needs for `size` buckets;
+    //   size_type index( hash ) const      -> the bucket of `hash`, in [0, size).
+
+    /// Prime bucket counts and a plain `%`. Slowest (one integer division per operation), but
+    /// a prime modulus uses every bit of the hash, so it is the safe choice for weak hashes.
+    /// Sizes come from the compile-time prime ladder (2, 5, 11, 23, ...), roughly doubling.
+    struct PrimeModPolicy {
+        using size_type = std::size_t;
+
+        static size_type bucket_count( size_type n_ ) { return detail::prime_step_for( n_ ).prime; }
+        void reset( size_type size_ ) { m_size = size_; }
+        size_type index( size_type hash_ ) const { return hash_ % m_size; }
+
+        size_type m_size{1}; //!< Current bucket count.
+    };
+
+    /// Prime bucket counts with Lemire's division-free remainder: each rung of the prime ladder
+    /// carries M = ceil(2^128 / size), and with it `h % size` is three multiplications.
+    struct FastModPolicy {
+        using size_type = std::size_t;
+
+        static size_type bucket_count( size_type n_ ) { return detail::prime_step_for( n_ ).prime; }
+
+        void reset( size_type size_ )
+        {
+            const detail::PrimeStep & step = detail::prime_step_for( size_ );
+            m_size = size_;
+            m_magic = step.prime == size_ ? step.magic : ~detail::uint128_t{0} / size_ + 1;
+        }
+
+        size_type index( size_type hash_ ) const
+        {
+            return static_cast<size_type>( detail::fast_mod( hash_, m_magic, m_size ) );
+        }
+
+        size_type m_size{1};            //!< Current bucket count.
+        detail::uint128_t m_magic{0};   //!< ceil(2^128 / m_size).
+    };
+
+    /// Power-of-two bucket counts with Fibonacci hashing: the hash is multiplied by 2^64/phi
+    /// and the top log2(size) bits select the bucket. The multiplication mixes the low bits
+    /// upwards, so even identity hashes (std::hash<int>) spread well.
+    struct FibonacciPolicy {
+        using size_type = std::size_t;
+
+        static size_type bucket_count( size_type n_ ) { return detail::next_power_of_two( n_ ); }
+
+        void reset( size_type size_ )
+        {
+            m_shift = 64;
+            for (size_type s = size_; s > 1; s >>= 1)
+                --m_shift;
+        }
+
+        size_type index( size_type hash_ ) const
+        {
+            return static_cast<size_type>( (static_cast<std::uint64_t>( hash_ ) * 11400714819323198485ULL) >> m_shift );
+        }
+
+        unsigned m_shift{63}; //!< 64 - log2(bucket count).
+    };
+
+    /// Power-of-two bucket counts indexed by the high bits of the hash (a multiply-high of the
+    /// hash by the bucket count). The cheapest mapping, but only the top bits of the hash are
+    /// used: pair it with a hash whose high bits are well mixed, never with identity hashes.
+    struct HighBitsPolicy {
+        using size_type = std::size_t;
+
+        static size_type bucket_count( size_type n_ ) { return detail::next_power_of_two( n_ ); }
+        void reset( size_type size_ ) { m_size = size_; }
+
+        size_type index( size_type hash_ ) const
+        {
+            return static_cast<size_type>( detail::mul_high( static_cast<std::uint64_t>( hash_ ), m_size ) );
+        }
+
+        size_type m_size{2}; //!< Current bucket count.
+    };
+
+} // namespace ac
+#endif
@@ -0,0 +1,121 @@
+#ifndef LOCK_FREE_HASHTBL_H
+#define LOCK_FREE_HASHTBL_H
+
+#include <array>        // segment directory
+#include <atomic>       // std::atomic
+#include <cstdint>      // uint64_t, uintptr_t
+#include <functional>   // std::hash, std::equal_to
+
+#include "growth_policy.h" // LoadFactorPolicy
+#include "index_policy.h"  // detail::next_power_of_two
+#include "hash_utils.h"    // detail::mix_hash
+#include "epoch.h"         // EpochDomain, EpochGuard
+
+namespace ac // Associative container
+{
+    /// Lock-free hash table on a split-ordered list (Shalev and Shavit). Every entry lives in
+    /// one lock-free sorted linked list, ordered by the bit-reversed hash; bucket `b` is a
+    /// shortcut into the list, a sentinel node inserted on first use right after the sentinel
+    /// of its parent bucket (`b` without its highest bit). Growing doubles the bucket count
+    /// with a single compare-and-swap: no node ever moves, the new buckets split their
+    /// parents' ranges as they are initialized, and no operation waits for a resize.
+    ///
+    /// Insert, lookup and erase are lock-free: a thread that fails a compare-and-swap retries
+    /// only because another one made progress. Deleted nodes are marked, unlinked and
+    /// retired to the global EpochDomain, as are replaced data; retiring is lock-free too, so
+    /// a lookup that helps unlink a marked node never waits. New nodes and data come from the
+    /// global operator new, whose own progress guarantee this table inherits. The bucket
+    /// count is a power of two and the hash is mixed (detail::mix_hash) so its low bits are
+    /// well spread; the growth policy only decides when to double. The table never shrinks.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType >,
+              class GrowthPolicy = LoadFactorPolicy >
+    class LockFreeHashTbl {
+        public:
+            // Aliases
+            using size_type = std::size_t;
+
+            explicit LockFreeHashTbl( size_type table_sz_ = DEFAULT_SIZE, const GrowthPolicy & growth_ = GrowthPolicy() );
+            LockFreeHashTbl( const LockFreeHashTbl & ) = delete;
+            LockFreeHashTbl& operator=( const LockFreeHashTbl & ) = delete;
+
+            virtual ~LockFreeHashTbl();
+
+            /// Inserts, or updates the data of an existing key. Returns true on insertion.
+            bool insert( const KeyType &, const DataType & );
+            /// Inserts, or assigns `obj_` to the data of an existing key. Returns true on insertion.
+            template< class M >
+            bool insert_or_assign( const KeyType & key_, M && obj_ );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool contains( const KeyType & ) const;
+            bool erase( const KeyType & );
+            bool empty() const;
+            /// Number of entries; exact whenever no writer is running.
+            size_type size() const;
+            size_type bucket_count() const;
+            float max_load_factor() const;
+            float load_factor() const;
+            /// Makes room for `n_` elements without further growth. Never shrinks.
+            void reserve( size_type n_ );
+
+        private:
+            /// A list node: a bucket sentinel (even split-order key) or the head of an Entry
+            /// (odd key). The low bit of `next` marks the node itself as deleted.
+            struct Node {
+                explicit Node( std::uint64_t so_key_ ) : so_key{ so_key_ } {}
+
+                const std::uint64_t so_key;
+                std::atomic< Node * > next{ nullptr };
+            };
+
+            /// An element. The data is replaced as a whole, never changed in place.
+            struct Entry : Node {
+                Entry( std::uint64_t so_key_, KeyType key_, DataType * data_ )
+                    : Node{ so_key_ }, key{ std::move( key_ ) }, data{ data_ } {}
+
+                const KeyType key;
+                std::atomic< DataType * > data;
+            };
+
+            /// Where a search stopped: the link to `curr`, and whether `curr` is the match.
+            struct Position {
+                std::atomic< Node * > *prev;
+                Node *curr;
+                bool found;
+            };
+
+            //! Directory size: segment s > 0 holds buckets [2^s, 2^(s+1)), segment 0 buckets 0 and 1.
+            static constexpr size_type SEGMENTS = 64;
+
+            static std::uint64_t reverse( std::uint64_t );
+            static std::uint64_t regular_key( std::uint64_t hash_ ) { return reverse( hash_ | (1ULL << 63) ); }
+            static std::uint64_t sentinel_key( size_type bucket_ ) { return reverse( bucket_ ); }
+            static bool is_marked( Node * p_ ) { return reinterpret_cast<std::uintptr_t>( p_ ) & 1; }
+            static Node * marked( Node * p_ ) { return reinterpret_cast<Node *>( reinterpret_cast<std::uintptr_t>( p_ ) | 1 ); }
+            static Node * unmarked( Node * p_ ) { return reinterpret_cast<Node *>( reinterpret_cast<std::uintptr_t>( p_ ) & ~std::uintptr_t{ 1 } ); }
+            static void destroy_node( void * );
+            static void destroy_data( void * );
+            static std::uint64_t hash_of( const KeyType & );
+
+            Position find( Node *, std::uint64_t, const KeyType * ) const;
+            std::atomic< Node * > & bucket_slot( size_type ) const;
+            Node * bucket_head( size_type ) const;
+            Node * init_bucket( size_type ) const;
+            template< class M >
+            bool insert_impl( const KeyType &, M && );
+
+        private:
+            //! Segmentos de buckets, alocados sob demanda e nunca movidos.
+            mutable std::array< std::atomic< std::atomic< Node * > * >, SEGMENTS > m_segments;
+            std::atomic< size_type > m_size;  //!< Quantidade de buckets em uso, potência de 2.
+            std::atomic< size_type > m_count; //!< Quantidade de elementos.
+            GrowthPolicy m_growth;            //!< Só decide quando dobrar; nunca é alterada.
+
+            static const short DEFAULT_SIZE = 16;
+    };
+
+} // namespace ac
+#include "lock_free_hashtbl.inl"
+#endif
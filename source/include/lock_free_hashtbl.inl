@@ -0,0 +1,356 @@
+#include "lock_free_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::LockFreeHashTbl(size_type sz, const GrowthPolicy &growth)
+        : m_size{detail::next_power_of_two(sz)}, m_count{0}, m_growth{growth}
+    {
+        for (auto &segment : m_segments)
+        {
+            segment.store(nullptr, std::memory_order_relaxed);
+        }
+        // O sentinela do bucket 0 é a cabeça da lista inteira
+        bucket_slot(0).store(new Node(sentinel_key(0)), std::memory_order_release);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::~LockFreeHashTbl()
+    {
+        // Nós já desligados pertencem à época; os que restam, marcados ou não, estão na lista
+        for (Node *node = bucket_slot(0).load(std::memory_order_acquire); node != nullptr;)
+        {
+            Node *next = unmarked(node->next.load(std::memory_order_relaxed));
+            destroy_node(node);
+            node = next;
+        }
+        for (auto &segment : m_segments)
+        {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        return insert_impl(key_, new_data_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    template <typename M>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::insert_or_assign(const KeyType &key_, M &&obj_)
+    {
+        return insert_impl(key_, std::forward<M>(obj_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        EpochGuard pin;
+        const std::uint64_t hash = hash_of(key_);
+        const Position pos = find(bucket_head(hash & (m_size.load(std::memory_order_acquire) - 1)), regular_key(hash), &key_);
+        if (!pos.found)
+        {
+            return false;
+        }
+        data_item_ = *static_cast<Entry *>(pos.curr)->data.load(std::memory_order_acquire);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::contains(const KeyType &key_) const
+    {
+        EpochGuard pin;
+        const std::uint64_t hash = hash_of(key_);
+        return find(bucket_head(hash & (m_size.load(std::memory_order_acquire) - 1)), regular_key(hash), &key_).found;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::erase(const KeyType &key_)
+    {
+        EpochGuard pin;
+        const std::uint64_t hash = hash_of(key_);
+        const std::uint64_t so_key = regular_key(hash);
+        Node *head = bucket_head(hash & (m_size.load(std::memory_order_acquire) - 1));
+
+        for (;;)
+        {
+            const Position pos = find(head, so_key, &key_);
+            if (!pos.found)
+            {
+                return false;
+            }
+
+            // Remoção lógica: marca o próprio nó, o que impede inserções logo após ele
+            Node *next = pos.curr->next.load(std::memory_order_acquire);
+            if (is_marked(next) || !pos.curr->next.compare_exchange_strong(next, marked(next), std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                continue;
+            }
+            m_count.fetch_sub(1, std::memory_order_relaxed);
+
+            // Remoção física; se falhar, uma nova busca desliga o nó marcado
+            Node *expected = pos.curr;
+            if (pos.prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                EpochDomain::global().retire(pos.curr, &destroy_node);
+            }
+            else
+            {
+                find(head, so_key, &key_);
+            }
+            return true;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::size_type
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::size() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::size_type
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::bucket_count() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    float LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::max_load_factor() const
+    {
+        return m_growth.max_load_factor();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    float LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::load_factor() const
+    {
+        return static_cast<float>(size()) / bucket_count();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    void LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::reserve(size_type n_)
+    {
+        // Basta publicar o novo tamanho: os buckets novos se inicializam no primeiro uso
+        const size_type target = detail::next_power_of_two(m_growth.buckets_for(n_));
+        size_type size = m_size.load(std::memory_order_relaxed);
+        while (size < target && !m_size.compare_exchange_weak(size, target, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    std::uint64_t LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::reverse(std::uint64_t x_)
+    {
+        x_ = ((x_ >> 1) & 0x5555555555555555ULL) | ((x_ & 0x5555555555555555ULL) << 1);
+        x_ = ((x_ >> 2) & 0x3333333333333333ULL) | ((x_ & 0x3333333333333333ULL) << 2);
+        x_ = ((x_ >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x_ & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        return __builtin_bswap64(x_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    void LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::destroy_node(void *node_)
+    {
+        Node *node = static_cast<Node *>(node_);
+        if (node->so_key & 1) // Chaves ímpares são elementos; pares, sentinelas
+        {
+            Entry *entry = static_cast<Entry *>(node);
+            delete entry->data.load(std::memory_order_relaxed);
+            delete entry;
+        }
+        else
+        {
+            delete node;
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    void LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::destroy_data(void *data_)
+    {
+        delete static_cast<DataType *>(data_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    std::uint64_t LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::hash_of(const KeyType &key_)
+    {
+        // Os buckets usam os bits baixos do hash, que precisam estar bem espalhados
+        return detail::mix_hash(KeyHash()(key_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::Position
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::find(Node *head_, std::uint64_t so_key_, const KeyType *key_) const
+    {
+        // Chamado com a época fixada. Procura o sentinela `so_key_` (key_ nulo) ou o elemento
+        // `*key_`, desligando pelo caminho os nós marcados como removidos
+        for (;;)
+        {
+            std::atomic<Node *> *prev = &head_->next;
+            Node *curr = prev->load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (is_marked(curr))
+                {
+                    break; // O antecessor foi removido: recomeça do sentinela
+                }
+                if (curr == nullptr)
+                {
+                    return {prev, nullptr, false};
+                }
+
+                Node *next = curr->next.load(std::memory_order_acquire);
+                if (is_marked(next))
+                {
+                    Node *expected = curr;
+                    if (!prev->compare_exchange_strong(expected, unmarked(next), std::memory_order_acq_rel, std::memory_order_acquire))
+                    {
+                        break;
+                    }
+                    EpochDomain::global().retire(curr, &destroy_node);
+                    curr = unmarked(next);
+                    continue;
+                }
+
+                if (curr->so_key > so_key_)
+                {
+                    return {prev, curr, false};
+                }
+                // Hashes iguais formam uma sequência sem ordem: compara as chaves de todos
+                if (curr->so_key == so_key_ && (key_ == nullptr || KeyEqual()(static_cast<Entry *>(curr)->key, *key_)))
+                {
+                    return {prev, curr, true};
+                }
+                prev = &curr->next;
+                curr = next;
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    std::atomic<typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::Node *> &
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::bucket_slot(size_type bucket_) const
+    {
+        const size_type segment = bucket_ < 2 ? 0 : 63 - __builtin_clzll(bucket_);
+        const size_type first = segment == 0 ? 0 : size_type{1} << segment;
+
+        std::atomic<Node *> *slots = m_segments[segment].load(std::memory_order_acquire);
+        if (slots == nullptr)
+        {
+            // Aloca o segmento; se outra thread chegou antes, usa o dela
+            const size_type n = segment == 0 ? 2 : size_type{1} << segment;
+            std::atomic<Node *> *fresh = new std::atomic<Node *>[n];
+            for (size_type i = 0; i < n; ++i)
+            {
+                fresh[i].store(nullptr, std::memory_order_relaxed);
+            }
+            if (m_segments[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                slots = fresh;
+            }
+            else
+            {
+                delete[] fresh;
+            }
+        }
+        return slots[bucket_ - first];
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::Node *
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::bucket_head(size_type bucket_) const
+    {
+        Node *head = bucket_slot(bucket_).load(std::memory_order_acquire);
+        return head != nullptr ? head : init_bucket(bucket_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    typename LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::Node *
+    LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::init_bucket(size_type bucket_) const
+    {
+        // O pai é o bucket sem o bit mais alto: seu sentinela precede o deste na lista
+        const size_type parent = bucket_ ^ (size_type{1} << (63 - __builtin_clzll(bucket_)));
+        Node *parent_head = bucket_head(parent);
+
+        const std::uint64_t so_key = sentinel_key(bucket_);
+        Node *sentinel = new Node(so_key);
+        for (;;)
+        {
+            const Position pos = find(parent_head, so_key, nullptr);
+            if (pos.found)
+            {
+                delete sentinel; // Outra thread já o inseriu, e o nosso nunca foi publicado
+                sentinel = pos.curr;
+                break;
+            }
+            sentinel->next.store(pos.curr, std::memory_order_relaxed);
+            Node *expected = pos.curr;
+            if (pos.prev->compare_exchange_strong(expected, sentinel, std::memory_order_release, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        // Há um só sentinela por bucket na lista, então qualquer thread publica o mesmo
+        Node *expected = nullptr;
+        bucket_slot(bucket_).compare_exchange_strong(expected, sentinel, std::memory_order_release, std::memory_order_relaxed);
+        return sentinel;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename GrowthPolicy>
+    template <typename M>
+    bool LockFreeHashTbl<KeyType, DataType, KeyHash, KeyEqual, GrowthPolicy>::insert_impl(const KeyType &key_, M &&data_)
+    {
+        EpochGuard pin;
+        const std::uint64_t hash = hash_of(key_);
+        const std::uint64_t so_key = regular_key(hash);
+        size_type size = m_size.load(std::memory_order_acquire);
+        Node *head = bucket_head(hash & (size - 1));
+
+        Entry *entry = nullptr;
+        for (;;)
+        {
+            const Position pos = find(head, so_key, &key_);
+            if (pos.found)
+            {
+                // A chave já existe: publica um dado novo e aposenta o antigo
+                DataType *fresh = entry != nullptr ? entry->data.exchange(nullptr, std::memory_order_relaxed)
+                                                   : new DataType(std::forward<M>(data_));
+                DataType *old = static_cast<Entry *>(pos.curr)->data.exchange(fresh, std::memory_order_acq_rel);
+                EpochDomain::global().retire(old, &destroy_data);
+                if (entry != nullptr)
+                {
+                    destroy_node(entry);
+                }
+                return false;
+            }
+
+            if (entry == nullptr)
+            {
+                entry = new Entry(so_key, key_, new DataType(std::forward<M>(data_)));
+            }
+            entry->next.store(pos.curr, std::memory_order_relaxed);
+            Node *expected = pos.curr;
+            if (pos.prev->compare_exchange_strong(expected, entry, std::memory_order_release, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        // Crescer é só dobrar o índice; se outra thread já dobrou, nada a fazer
+        const size_type count = m_count.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (m_growth.grow_to(count, size) != 0)
+        {
+            m_size.compare_exchange_strong(size, size * 2, std::memory_order_acq_rel, std::memory_order_relaxed);
+        }
+        return true;
+    }
+} // Namespace ac.
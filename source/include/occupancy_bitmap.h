@@ -0,0 +1,77 @@
+#ifndef OCCUPANCY_BITMAP_H
+#define OCCUPANCY_BITMAP_H
+
+#include <algorithm> // fill_n
+#include <cstddef>   // size_t
+#include <cstdint>   // uint64_t
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        /// One bit per bucket, set while the bucket holds entries. Iterators use it to jump
+        /// over runs of empty buckets 64 at a time instead of visiting each of them.
+        /// The words are not owned: the table allocates them in the same block as its
+        /// buckets, so they live and die with the bucket array they describe.
+        class OccupancyBitmap {
+            public:
+                using size_type = std::size_t;
+                static constexpr size_type npos = static_cast<size_type>( -1 );
+
+                /// Words needed for `n_` buckets.
+                static constexpr size_type words_for( size_type n_ ) { return (n_ + 63) / 64; }
+
+                /// Views `words_for(n_)` words at `words_` as `n_` buckets, all empty.
+                void reset( std::uint64_t * words_, size_type n_ )
+                {
+                    m_words = words_;
+                    m_n_words = words_for( n_ );
+                    reset();
+                }
+                /// Every bucket empty, same storage.
+                void reset() { std::fill_n( m_words, m_n_words, std::uint64_t{0} ); }
+                /// Drops the view.
+                void clear() { m_words = nullptr; m_n_words = 0; }
+
+                void set( size_type i_ ) { m_words[i_ / 64] |= bit( i_ ); }
+                void unset( size_type i_ ) { m_words[i_ / 64] &= ~bit( i_ ); }
+                bool test( size_type i_ ) const { return (m_words[i_ / 64] & bit( i_ )) != 0; }
+
+                /// The first set bit at or after `from_`, or npos.
+                size_type next( size_type from_ ) const
+                {
+                    size_type w = from_ / 64;
+                    if (w >= m_n_words)
+                        return npos;
+
+                    // Descarta os bits abaixo de from_ na primeira palavra.
+                    std::uint64_t word = m_words[w] & (~std::uint64_t{0} << (from_ % 64));
+                    while (word == 0)
+                    {
+                        if (++w == m_n_words)
+                            return npos;
+                        word = m_words[w];
+                    }
+                    return w * 64 + lowest( word );
+                }
+
+            private:
+                static std::uint64_t bit( size_type i_ ) { return std::uint64_t{1} << (i_ % 64); }
+
+                static size_type lowest( std::uint64_t word_ )
+                {
+#if defined(__GNUC__)
+                    return static_cast<size_type>( __builtin_ctzll( word_ ) );
+#else
+                    size_type i{0};
+                    while ( (word_ & 1u) == 0 ) { word_ >>= 1; ++i; }
+                    return i;
+#endif
+                }
+
+                std::uint64_t * m_words = nullptr; //!< Palavras do bloco dos buckets.
+                size_type m_n_words = 0;           //!< Quantidade de palavras.
+        };
+    } // namespace detail
+} // namespace ac
+#endif
@@ -0,0 +1,209 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <algorithm>    // std::max, std::find_if
+#include <cstddef>      // size_t, max_align_t
+#include <memory>       // std::allocator, std::shared_ptr, std::unique_ptr
+#include <new>          // operator new, std::align_val_t
+#include <type_traits>  // std::true_type, std::false_type
+#include <utility>      // std::declval
+#include <vector>       // chunk list
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        /// Fixed-size node pool: nodes are carved from chunks that grow geometrically,
+        /// erased nodes go to an intrusive free list, and release() frees every chunk at once.
+        class NodePool {
+            public:
+                using size_type = std::size_t;
+
+                NodePool( size_type node_size_, size_type align_ )
+                    : m_align{ std::max( align_, alignof( FreeNode ) ) },
+                      m_node_size{ round_up( std::max( node_size_, sizeof( FreeNode ) ), m_align ) }
+                { /* empty */ }
+
+                NodePool( const NodePool & ) = delete;
+                NodePool & operator=( const NodePool & ) = delete;
+                ~NodePool() { release(); }
+
+                void * allocate()
+                {
+                    ++m_live;
+                    if (m_free != nullptr)
+                    {
+                        FreeNode *node = m_free;
+                        m_free = node->next;
+                        return node;
+                    }
+                    if (m_cursor == m_end)
+                        add_chunk();
+                    void *node = m_cursor;
+                    m_cursor += m_node_size;
+                    return node;
+                }
+
+                void deallocate( void * p_ )
+                {
+                    // O nó liberado vira a cabeça da lista de livres.
+                    m_free = ::new ( p_ ) FreeNode{ m_free };
+                    --m_live;
+                }
+
+                /// Frees every chunk; all nodes handed out so far become invalid.
+                void release()
+                {
+                    for (char *chunk : m_chunks)
+                        ::operator delete( chunk, std::align_val_t{ m_align } );
+                    m_chunks.clear();
+                    m_free = nullptr;
+                    m_cursor = m_end = nullptr;
+                    m_chunk_nodes = FIRST_CHUNK_NODES;
+                }
+
+                size_type node_size() const { return m_node_size; }
+                size_type align() const { return m_align; }
+                size_type chunks() const { return m_chunks.size(); }
+                /// Nodes handed out and not yet given back.
+                size_type live() const { return m_live; }
+
+            private:
+                struct FreeNode {
+                    FreeNode *next;
+                };
+
+                static constexpr size_type FIRST_CHUNK_NODES = 64;   //!< Nodes in the first chunk.
+                static constexpr size_type MAX_CHUNK_NODES = 65536;  //!< Chunks stop doubling here.
+
+                static size_type round_up( size_type n_, size_type align_ ) { return (n_ + align_ - 1) / align_ * align_; }
+
+                void add_chunk()
+                {
+                    const size_type bytes = m_chunk_nodes * m_node_size;
+                    m_chunks.push_back( static_cast<char *>( ::operator new( bytes, std::align_val_t{ m_align } ) ) );
+                    m_cursor = m_chunks.back();
+                    m_end = m_cursor + bytes;
+                    m_chunk_nodes = std::min( m_chunk_nodes * 2, MAX_CHUNK_NODES );
+                }
+
+                size_type m_align;                     //!< Node alignment.
+                size_type m_node_size;                 //!< Node size, rounded up to the alignment.
+                size_type m_chunk_nodes{ FIRST_CHUNK_NODES }; //!< Nodes in the next chunk.
+                std::vector< char * > m_chunks;        //!< Every chunk allocated so far.
+                FreeNode *m_free{ nullptr };           //!< Head of the free list.
+                char *m_cursor{ nullptr };             //!< Next never-used node of the last chunk.
+                char *m_end{ nullptr };                //!< End of the last chunk.
+                size_type m_live{ 0 };                 //!< Nós entregues e ainda não devolvidos.
+        };
+
+        /// The pools shared by every copy (and rebind) of one PoolAllocator, one per node layout.
+        class PoolResource {
+            public:
+                NodePool & pool_for( std::size_t size_, std::size_t align_ )
+                {
+                    NodePool probe{ size_, align_ };
+                    auto it = std::find_if( m_pools.begin(), m_pools.end(), [&probe]( const std::unique_ptr<NodePool> & p ) {
+                        return p->node_size() == probe.node_size() && p->align() == probe.align();
+                    } );
+                    if (it != m_pools.end())
+                        return **it;
+                    m_pools.push_back( std::make_unique<NodePool>( size_, align_ ) );
+                    return *m_pools.back();
+                }
+
+                /// Frees the chunks of every pool with no live node. A pool still holding nodes of
+                /// another container that shares it (a table moved from) keeps its chunks.
+                void release()
+                {
+                    for (auto & pool : m_pools)
+                    {
+                        if (pool->live() == 0)
+                            pool->release();
+                    }
+                }
+
+                std::size_t chunks() const
+                {
+                    std::size_t total = 0;
+                    for (const auto & pool : m_pools)
+                        total += pool->chunks();
+                    return total;
+                }
+
+            private:
+                std::vector< std::unique_ptr<NodePool> > m_pools;
+        };
+
+        /// Detects allocators that can free all of their memory at once (see PoolAllocator::release).
+        template< class Alloc, class = void >
+        struct has_release : std::false_type {};
+
+        template< class Alloc >
+        struct has_release< Alloc, std::void_t< decltype( std::declval<Alloc &>().release() ) > > : std::true_type {};
+    } // namespace detail
+
+    /// Node allocator for the chained tables: single-object allocations (list nodes) come from
+    /// a pool of large chunks and are recycled through a free list; larger requests fall back
+    /// to std::allocator. All copies and rebinds of an allocator share one pool, and the
+    /// container's own copy gets a fresh one. release() returns to the system the chunks of
+    /// every pool none of whose nodes is alive, which is how HashTbl::clear() uses it.
+    /// Not thread-safe: a pool belongs to a single table (and to the tables moved from it,
+    /// which keep a copy of its allocator).
+    template< class T >
+    class PoolAllocator {
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using propagate_on_container_copy_assignment = std::true_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+            using is_always_equal = std::false_type;
+
+            PoolAllocator() : m_resource{ std::make_shared<detail::PoolResource>() } { /* empty */ }
+
+            template< class U >
+            PoolAllocator( const PoolAllocator<U> & other_ ) noexcept : m_resource{ other_.m_resource } { /* empty */ }
+
+            T * allocate( size_type n_ )
+            {
+                if (n_ == 1)
+                    return static_cast<T *>( pool().allocate() );
+                return std::allocator<T>().allocate( n_ );
+            }
+
+            void deallocate( T * p_, size_type n_ )
+            {
+                if (n_ == 1)
+                    pool().deallocate( p_ );
+                else
+                    std::allocator<T>().deallocate( p_, n_ );
+            }
+
+            /// A copied container must not share (and later release) the source's pool.
+            PoolAllocator select_on_container_copy_construction() const { return PoolAllocator(); }
+
+            void release() { m_resource->release(); }
+            size_type chunks() const { return m_resource->chunks(); }
+
+            template< class U >
+            bool operator==( const PoolAllocator<U> & other_ ) const { return m_resource == other_.m_resource; }
+            template< class U >
+            bool operator!=( const PoolAllocator<U> & other_ ) const { return !( *this == other_ ); }
+
+        private:
+            template< class U > friend class PoolAllocator;
+
+            detail::NodePool & pool()
+            {
+                if (m_pool == nullptr)
+                    m_pool = &m_resource->pool_for( sizeof( T ), alignof( T ) );
+                return *m_pool;
+            }
+
+            std::shared_ptr< detail::PoolResource > m_resource; //!< Pools shared by every copy.
+            detail::NodePool *m_pool{ nullptr };                 //!< Cached pool for sizeof(T).
+    };
+
+} // namespace ac
+#endif
@@ -0,0 +1,119 @@
+#ifndef PRIME_LADDER_H
+#define PRIME_LADDER_H
+
+#include <algorithm>  // std::lower_bound
+#include <array>      // std::array
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+
+namespace ac // Associative container
+{
+    namespace detail
+    {
+        //! Unsigned 128-bit integer, used for the modular arithmetic and the fastmod constants.
+        using uint128_t = unsigned __int128;
+
+        constexpr std::uint64_t mul_mod( std::uint64_t a_, std::uint64_t b_, std::uint64_t m_ )
+        {
+            return static_cast<std::uint64_t>( static_cast<uint128_t>( a_ ) * b_ % m_ );
+        }
+
+        constexpr std::uint64_t pow_mod( std::uint64_t base_, std::uint64_t exp_, std::uint64_t m_ )
+        {
+            std::uint64_t result = 1;
+            base_ %= m_;
+            for (; exp_ > 0; exp_ >>= 1)
+            {
+                if (exp_ & 1)
+                    result = mul_mod( result, base_, m_ );
+                base_ = mul_mod( base_, base_, m_ );
+            }
+            return result;
+        }
+
+        /// Miller-Rabin with the first twelve primes as bases, which is deterministic for 64 bits.
+        constexpr bool is_prime( std::uint64_t n_ )
+        {
+            constexpr std::uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+            if (n_ < 2)
+                return false;
+            for (auto p : bases)
+            {
+                if (n_ % p == 0)
+                    return n_ == p;
+            }
+
+            std::uint64_t d = n_ - 1;
+            unsigned r = 0;
+            for (; (d & 1) == 0; d >>= 1)
+                ++r;
+
+            for (auto a : bases)
+            {
+                std::uint64_t x = pow_mod( a, d, n_ );
+                if (x == 1 || x == n_ - 1)
+                    continue;
+
+                bool composite = true;
+                for (unsigned i = 1; i < r && composite; ++i)
+                {
+                    x = mul_mod( x, x, n_ );
+                    composite = x != n_ - 1;
+                }
+                if (composite)
+                    return false;
+            }
+            return true;
+        }
+
+        /// One rung of the ladder: a prime bucket count and its fastmod constant ceil(2^128 / prime).
+        struct PrimeStep {
+            std::uint64_t prime;
+            uint128_t magic;
+        };
+
+        //! Rungs from 2 up to the last prime below 2^63.
+        constexpr std::size_t PRIME_LADDER_SIZE = 62;
+
+        /// Each rung is the first prime greater than twice the previous one: 2, 5, 11, 23, 47...
+        constexpr std::array<PrimeStep, PRIME_LADDER_SIZE> make_prime_ladder()
+        {
+            std::array<PrimeStep, PRIME_LADDER_SIZE> ladder{};
+            std::uint64_t prime = 2;
+            for (std::size_t i = 0; i < PRIME_LADDER_SIZE; ++i)
+            {
+                ladder[i] = PrimeStep{ prime, ~uint128_t{0} / prime + 1 };
+
+                prime = 2 * prime + 1;
+                while (!is_prime( prime ))
+                    prime += 2;
+            }
+            return ladder;
+        }
+
+        //! Generated at compile time; rehash() only ever searches this table.
+        inline constexpr std::array<PrimeStep, PRIME_LADDER_SIZE> PRIME_LADDER = make_prime_ladder();
+
+        static_assert( PRIME_LADDER[3].prime == 23 && PRIME_LADDER[11].prime == 6421, "unexpected prime ladder" );
+        static_assert( PRIME_LADDER[PRIME_LADDER_SIZE - 1].prime < (std::uint64_t{1} << 63), "prime ladder overflow" );
+
+        /// The first rung whose prime is not less than `n_` (the top rung if none is).
+        /// A binary search over 62 entries: no division and no primality test at run time.
+        inline const PrimeStep & prime_step_for( std::uint64_t n_ )
+        {
+            auto it = std::lower_bound( PRIME_LADDER.begin(), PRIME_LADDER.end(), n_,
+                                        []( const PrimeStep & step, std::uint64_t n ) { return step.prime < n; } );
+            return it != PRIME_LADDER.end() ? *it : PRIME_LADDER.back();
+        }
+
+        /// `a_ % d_` for the `magic_` = ceil(2^128 / d_) of the ladder, exact for all 64-bit operands.
+        inline std::uint64_t fast_mod( std::uint64_t a_, uint128_t magic_, std::uint64_t d_ )
+        {
+            const uint128_t low_bits = magic_ * a_;
+            const uint128_t bottom = ( (low_bits & ~std::uint64_t{0}) * d_ ) >> 64;
+            const uint128_t top = (low_bits >> 64) * d_;
+            return static_cast<std::uint64_t>( (bottom + top) >> 64 );
+        }
+    } // namespace detail
+} // namespace ac
+#endif
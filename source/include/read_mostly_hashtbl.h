@@ -0,0 +1,143 @@
+#ifndef READ_MOSTLY_HASHTBL_H
+#define READ_MOSTLY_HASHTBL_H
+
+#include <array>        // stripes
+#include <atomic>       // std::atomic
+#include <functional>   // std::hash, std::equal_to
+#include <mutex>        // std::mutex, std::lock_guard
+
+#include "hashtbl.h"    // HashEntry, index and growth policies
+#include "hash_utils.h" // detail::CACHE_LINE
+#include "epoch.h"      // EpochDomain, EpochGuard
+
+namespace ac // Associative container
+{
+    /// Thread-safe chained hash table for read-mostly workloads. Readers take no lock and
+    /// perform no atomic read-modify-write: they pin the epoch (EpochGuard) and walk the
+    /// chains with acquire loads. Writers serialize per bucket range on striped mutexes and
+    /// never change a published node: an update links in a new node and retires the old one
+    /// to the global EpochDomain, which frees it once no reader can still see it.
+    ///
+    /// Growing (and rehash()) copies the entries into a new bucket array and publishes it
+    /// with one store; readers still walking the old array see a consistent snapshot, and the
+    /// old array and its nodes are retired as a whole. Keys and data must be copyable.
+    /// Lookups copy data out (retrieve) or lend it for the duration of a call (visit).
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType >,
+              class IndexPolicy = PrimeModPolicy,
+              class GrowthPolicy = LoadFactorPolicy >
+    class ReadMostlyHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using size_type  = std::size_t;
+
+            //! Number of writer locks, each covering a contiguous range of buckets.
+            static constexpr size_type STRIPES = 64;
+
+            explicit ReadMostlyHashTbl( size_type table_sz_ = DEFAULT_SIZE, const GrowthPolicy & growth_ = GrowthPolicy() );
+            ReadMostlyHashTbl( const ReadMostlyHashTbl & ) = delete;
+            ReadMostlyHashTbl& operator=( const ReadMostlyHashTbl & ) = delete;
+
+            virtual ~ReadMostlyHashTbl();
+
+            /// Inserts, or updates the data of an existing key. Returns true on insertion.
+            bool insert( const KeyType &, const DataType & );
+            /// Inserts, or assigns `obj_` to the data of an existing key. Returns true on insertion.
+            template< class M >
+            bool insert_or_assign( const KeyType & key_, M && obj_ );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool contains( const KeyType & ) const;
+            /// Calls `fn_( data )` with a const reference to the data of `key_`, valid only during
+            /// the call, without copying it. Returns false, without calling `fn_`, on a miss.
+            template< class Fn >
+            bool visit( const KeyType & key_, Fn && fn_ ) const;
+            bool erase( const KeyType & );
+            /// Replaces the data of `key_` by a copy modified through `fn_( data )`, atomically
+            /// with respect to other writers. Returns false, without calling `fn_`, on a miss.
+            template< class Fn >
+            bool update( const KeyType & key_, Fn && fn_ );
+            void clear();
+            bool empty() const;
+            /// Sum of the per-stripe counts; exact whenever no writer is running.
+            size_type size() const;
+            size_type bucket_count() const;
+            float max_load_factor() const;
+            void max_load_factor( float mlf );
+            float load_factor() const;
+            /// Makes room for `n_` elements without further growth. Never shrinks.
+            void reserve( size_type n_ );
+            /// Sizes the table for at least `n_` buckets and the current elements.
+            void rehash( size_type n_ );
+
+        private:
+            /// A published node is never modified, except for its link to the next one.
+            struct Node {
+                Node( entry_type entry_, size_type hash_ ) : entry{ std::move( entry_ ) }, hash{ hash_ } {}
+
+                const entry_type entry;
+                const size_type hash;
+                std::atomic< Node * > next{ nullptr };
+            };
+
+            /// A bucket array and how hashes map into it, replaced as a whole on resize.
+            struct Table {
+                size_type size;
+                IndexPolicy index;
+                std::atomic< Node * > *buckets;
+            };
+
+            /// A writer lock and the number of entries in its buckets, alone in a cache line.
+            struct alignas( detail::CACHE_LINE ) Stripe {
+                std::mutex lock;
+                std::atomic< size_type > count{ 0 };
+            };
+
+            /// Holds every stripe, locked in order so two of them cannot deadlock.
+            class AllStripes {
+                public:
+                    explicit AllStripes( const ReadMostlyHashTbl & table_ ) : m_stripes{ table_.m_stripes }
+                    {
+                        for (auto &stripe : m_stripes)
+                            stripe.lock.lock();
+                    }
+                    ~AllStripes()
+                    {
+                        for (auto it = m_stripes.rbegin(); it != m_stripes.rend(); ++it)
+                            it->lock.unlock();
+                    }
+                    AllStripes( const AllStripes & ) = delete;
+                    AllStripes & operator=( const AllStripes & ) = delete;
+
+                private:
+                    std::array< Stripe, STRIPES > & m_stripes;
+            };
+
+            static Table * new_table( size_type );
+            static void destroy_node( void * );
+            static void destroy_table( void * );
+            static void retire_table( Table * );
+            static size_type stripe_of( size_type, size_type );
+            const Node * find_node( const KeyType &, size_type ) const;
+            template< class Fn >
+            decltype(auto) locked_bucket( size_type, Fn && );
+            template< class M >
+            bool insert_impl( const KeyType &, M && );
+            void grow();
+            /// Publishes a resized copy and returns the replaced table (null if the size is
+            /// unchanged), to be retired once the stripes are released.
+            Table * resize( size_type );
+
+        private:
+            mutable std::array< Stripe, STRIPES > m_stripes; //!< Travas dos escritores, uma por faixa de buckets.
+            std::atomic< Table * > m_table;                  //!< Tabela atual; as antigas vão para a época.
+            GrowthPolicy m_growth;  //!< Lida sob qualquer trava, alterada só com todas.
+
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "read_mostly_hashtbl.inl"
+#endif
@@ -0,0 +1,426 @@
+#include "read_mostly_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::ReadMostlyHashTbl(size_type sz, const GrowthPolicy &growth)
+        : m_growth{growth}
+    {
+        m_table.store(new_table(IndexPolicy::bucket_count(sz)), std::memory_order_release);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::~ReadMostlyHashTbl()
+    {
+        // Tabelas e nós aposentados antes pertencem à época, que os libera por conta própria
+        destroy_table(m_table.load(std::memory_order_acquire));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        return insert_impl(key_, new_data_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    template <typename M>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::insert_or_assign(const KeyType &key_, M &&obj_)
+    {
+        return insert_impl(key_, std::forward<M>(obj_));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        EpochGuard pin;
+        const Node *node = find_node(key_, KeyHash()(key_));
+        if (node == nullptr)
+        {
+            return false;
+        }
+        data_item_ = node->entry.m_data; // Copia o dado enquanto o nó não pode ser liberado
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::contains(const KeyType &key_) const
+    {
+        EpochGuard pin;
+        return find_node(key_, KeyHash()(key_)) != nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    template <typename Fn>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::visit(const KeyType &key_, Fn &&fn_) const
+    {
+        EpochGuard pin;
+        const Node *node = find_node(key_, KeyHash()(key_));
+        if (node == nullptr)
+        {
+            return false;
+        }
+        fn_(node->entry.m_data);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::erase(const KeyType &key_)
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+
+        Node *unlinked = locked_bucket(hash, [&](std::atomic<Node *> &head, Stripe &stripe) -> Node *
+        {
+            std::atomic<Node *> *link = &head;
+            for (Node *curr = link->load(std::memory_order_relaxed); curr != nullptr; curr = link->load(std::memory_order_relaxed))
+            {
+                if (curr->hash == hash && KeyEqual()(curr->entry.m_key, key_))
+                {
+                    // Leitores já dentro do nó ainda seguem para o sucessor, que não muda
+                    link->store(curr->next.load(std::memory_order_relaxed), std::memory_order_release);
+                    stripe.count.fetch_sub(1, std::memory_order_relaxed);
+                    return curr;
+                }
+                link = &curr->next;
+            }
+            return nullptr;
+        });
+
+        // Fora da trava, como em retire_table(): aposentar pode liberar memória
+        if (unlinked == nullptr)
+            return false;
+        EpochDomain::global().retire(unlinked, &destroy_node);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    template <typename Fn>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::update(const KeyType &key_, Fn &&fn_)
+    {
+        const size_type hash = KeyHash()(key_);
+        EpochGuard pin;
+
+        Node *replaced = locked_bucket(hash, [&](std::atomic<Node *> &head, Stripe &) -> Node *
+        {
+            std::atomic<Node *> *link = &head;
+            for (Node *curr = link->load(std::memory_order_relaxed); curr != nullptr; curr = link->load(std::memory_order_relaxed))
+            {
+                if (curr->hash == hash && KeyEqual()(curr->entry.m_key, key_))
+                {
+                    // Modifica uma cópia: os leitores veem o dado antigo ou o novo, nunca um meio-termo
+                    DataType data = curr->entry.m_data;
+                    fn_(data);
+                    Node *node = new Node(entry_type{curr->entry.m_key, std::move(data)}, hash);
+                    node->next.store(curr->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    link->store(node, std::memory_order_release);
+                    return curr;
+                }
+                link = &curr->next;
+            }
+            return nullptr;
+        });
+
+        if (replaced == nullptr)
+            return false;
+        EpochDomain::global().retire(replaced, &destroy_node);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::clear()
+    {
+        Table *old = nullptr;
+        {
+            AllStripes all(*this);
+            old = m_table.load(std::memory_order_relaxed);
+
+            // Publica uma tabela vazia do mesmo tamanho; a antiga sai inteira, com seus nós
+            m_table.store(new_table(old->size), std::memory_order_release);
+            for (auto &stripe : m_stripes)
+            {
+                stripe.count.store(0, std::memory_order_relaxed);
+            }
+        }
+        retire_table(old);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::size_type
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::size() const
+    {
+        size_type total = 0;
+        for (const auto &stripe : m_stripes)
+        {
+            total += stripe.count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::size_type
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::bucket_count() const
+    {
+        EpochGuard pin;
+        return m_table.load(std::memory_order_acquire)->size;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    float ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::max_load_factor() const
+    {
+        std::lock_guard<std::mutex> guard(m_stripes[0].lock);
+        return m_growth.max_load_factor();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::max_load_factor(float mlf)
+    {
+        Table *old = nullptr;
+        {
+            AllStripes all(*this);
+            m_growth.max_load_factor(mlf);
+
+            const size_type target = m_growth.grow_to(size(), m_table.load(std::memory_order_relaxed)->size);
+            if (target != 0)
+            {
+                old = resize(target);
+            }
+        }
+        retire_table(old);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    float ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::load_factor() const
+    {
+        return static_cast<float>(size()) / bucket_count();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::reserve(size_type n_)
+    {
+        Table *old = nullptr;
+        {
+            AllStripes all(*this);
+            const size_type needed = m_growth.buckets_for(n_);
+            if (needed > m_table.load(std::memory_order_relaxed)->size)
+            {
+                old = resize(needed);
+            }
+        }
+        retire_table(old);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::rehash(size_type n_)
+    {
+        Table *old = nullptr;
+        {
+            AllStripes all(*this);
+            old = resize(std::max(n_, m_growth.buckets_for(size())));
+        }
+        retire_table(old);
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::Table *
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::new_table(size_type n_)
+    {
+        Table *table = new Table;
+        table->size = n_;
+        table->index.reset(n_);
+        table->buckets = new std::atomic<Node *>[n_];
+        for (size_type i = 0; i < n_; ++i)
+        {
+            table->buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+        return table;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::destroy_node(void *node_)
+    {
+        delete static_cast<Node *>(node_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::destroy_table(void *table_)
+    {
+        // Os nós ainda ligados à tabela só são alcançáveis por ela
+        Table *table = static_cast<Table *>(table_);
+        for (size_type i = 0; i < table->size; ++i)
+        {
+            for (Node *node = table->buckets[i].load(std::memory_order_relaxed); node != nullptr;)
+            {
+                Node *next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+        delete[] table->buckets;
+        delete table;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::retire_table(Table *table_)
+    {
+        // Fora das travas: aposentar pode liberar tabelas antigas, o que não deve bloquear escritores
+        if (table_ != nullptr)
+        {
+            EpochDomain::global().retire(table_, &destroy_table);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::size_type
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::stripe_of(size_type index_, size_type buckets_)
+    {
+        // Faixas contíguas: a trava s cobre os buckets [s * n / STRIPES, (s + 1) * n / STRIPES)
+        return index_ * STRIPES / buckets_;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    const typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::Node *
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::find_node(const KeyType &key_, size_type hash) const
+    {
+        // Chamado com a época fixada: nada do que se lê aqui pode ser liberado antes do fim
+        const Table *table = m_table.load(std::memory_order_acquire);
+        const Node *node = table->buckets[table->index.index(hash)].load(std::memory_order_acquire);
+        for (; node != nullptr; node = node->next.load(std::memory_order_acquire))
+        {
+            if (node->hash == hash && KeyEqual()(node->entry.m_key, key_))
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    template <typename Fn>
+    decltype(auto) ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::locked_bucket(size_type hash, Fn &&fn_)
+    {
+        // Chamado com a época fixada, então a tabela lida continua válida mesmo se substituída
+        for (;;)
+        {
+            Table *table = m_table.load(std::memory_order_acquire);
+            const size_type index = table->index.index(hash);
+            Stripe &stripe = m_stripes[stripe_of(index, table->size)];
+            std::lock_guard<std::mutex> guard(stripe.lock);
+
+            // Um resize entre a leitura da tabela e a trava a substitui: tenta de novo
+            if (table == m_table.load(std::memory_order_relaxed))
+            {
+                return fn_(table->buckets[index], stripe);
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    template <typename M>
+    bool ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::insert_impl(const KeyType &key_, M &&data_)
+    {
+        const size_type hash = KeyHash()(key_);
+        bool crowded = false;
+        Node *replaced = nullptr;
+        {
+            EpochGuard pin;
+            replaced = locked_bucket(hash, [&](std::atomic<Node *> &head, Stripe &stripe) -> Node *
+            {
+                std::atomic<Node *> *link = &head;
+                for (Node *curr = link->load(std::memory_order_relaxed); curr != nullptr; curr = link->load(std::memory_order_relaxed))
+                {
+                    if (curr->hash == hash && KeyEqual()(curr->entry.m_key, key_))
+                    {
+                        // A chave já existe: troca o nó inteiro, pois nós publicados são imutáveis
+                        Node *node = new Node(entry_type{key_, std::forward<M>(data_)}, hash);
+                        node->next.store(curr->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        link->store(node, std::memory_order_release);
+                        return curr;
+                    }
+                    link = &curr->next;
+                }
+
+                // O nó fica completo antes de a cabeça publicá-lo
+                Node *node = new Node(entry_type{key_, std::forward<M>(data_)}, hash);
+                node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                head.store(node, std::memory_order_release);
+                const size_type count = stripe.count.fetch_add(1, std::memory_order_relaxed) + 1;
+
+                // Estima o total pela carga desta faixa; só então vale a pena conferir com todas as travas
+                const size_type buckets = m_table.load(std::memory_order_relaxed)->size;
+                crowded = m_growth.grow_to(count * std::min(STRIPES, buckets), buckets) != 0;
+                return nullptr;
+            });
+        }
+
+        if (replaced != nullptr)
+        {
+            EpochDomain::global().retire(replaced, &destroy_node);
+        }
+        if (crowded)
+        {
+            grow();
+        }
+        return replaced == nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    void ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::grow()
+    {
+        Table *old = nullptr;
+        {
+            AllStripes all(*this);
+
+            // Outra thread pode ter crescido a tabela enquanto esta esperava pelas travas
+            const size_type target = m_growth.grow_to(size(), m_table.load(std::memory_order_relaxed)->size);
+            if (target != 0)
+            {
+                old = resize(target);
+            }
+        }
+        retire_table(old);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, typename IndexPolicy, typename GrowthPolicy>
+    typename ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::Table *
+    ReadMostlyHashTbl<KeyType, DataType, KeyHash, KeyEqual, IndexPolicy, GrowthPolicy>::resize(size_type buckets_)
+    {
+        // Chamado com todas as travas: nenhum escritor altera a tabela atual
+        Table *old = m_table.load(std::memory_order_relaxed);
+        const size_type new_size = IndexPolicy::bucket_count(buckets_);
+        if (new_size == old->size)
+        {
+            return nullptr;
+        }
+
+        // Copia as entradas, pois leitores ainda percorrem as listas antigas
+        Table *table = new_table(new_size);
+        std::array<size_type, STRIPES> counts{};
+        for (size_type i = 0; i < old->size; ++i)
+        {
+            for (Node *curr = old->buckets[i].load(std::memory_order_relaxed); curr != nullptr;
+                 curr = curr->next.load(std::memory_order_relaxed))
+            {
+                const size_type index = table->index.index(curr->hash);
+                Node *node = new Node(curr->entry, curr->hash);
+                node->next.store(table->buckets[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                table->buckets[index].store(node, std::memory_order_relaxed);
+                ++counts[stripe_of(index, new_size)];
+            }
+        }
+        for (size_type s = 0; s < STRIPES; ++s)
+        {
+            m_stripes[s].count.store(counts[s], std::memory_order_relaxed);
+        }
+
+        m_table.store(table, std::memory_order_release);
+        return old;
+    }
+} // Namespace ac.
@@ -0,0 +1,103 @@
+#ifndef ROBINHOOD_HASHTBL_H
+#define ROBINHOOD_HASHTBL_H
+
+#include <cstdint>      // uint8_t
+#include <cstring>      // memset
+#include <algorithm>    // std::min, std::max
+#include <functional>   // std::hash, std::equal_to
+#include <iostream>     // ostream
+#include <initializer_list>
+#include <memory>       // std::allocator
+#include <stdexcept>    // std::out_of_range
+#include <utility>      // std::swap, std::move
+#include <vector>       // overflow area
+
+#include "hashtbl.h"    // HashEntry
+#include "hash_utils.h" // mix_hash
+
+namespace ac // Associative container
+{
+    /// Linear-probing hash table with Robin Hood displacement.
+    /// On insertion an entry takes the slot of any resident that is closer to its home slot,
+    /// which keeps the variance of probe lengths low; erase() shifts the following run one slot
+    /// back instead of leaving tombstones, so erase/insert churn never degrades lookups.
+    /// A probe sequence that reaches MAX_DIST grows the table only once it is at least half
+    /// full; below that, growing could not split the keys (they share most of their hash),
+    /// and the entry goes to a small overflow area that a lookup scans after a miss.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class RobinHoodHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>;
+            using size_type  = std::size_t;
+
+            explicit RobinHoodHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            RobinHoodHashTbl( const RobinHoodHashTbl& );
+            RobinHoodHashTbl( const std::initializer_list< entry_type > & );
+            RobinHoodHashTbl& operator=( const RobinHoodHashTbl& );
+            RobinHoodHashTbl& operator=( const std::initializer_list< entry_type > & );
+
+            virtual ~RobinHoodHashTbl();
+
+            bool insert( const KeyType &, const DataType &  );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool erase( const KeyType & );
+            void clear();
+            bool empty() const;
+            inline size_type size() const { return m_count; };
+            DataType& at( const KeyType& );
+            DataType& operator[]( const KeyType& );
+            size_type count( const KeyType& ) const;
+            float max_load_factor() const;
+            void max_load_factor(float mlf);
+
+            //=== Introspection: displacement is how far an entry sits from its home slot.
+            size_type max_displacement() const;
+            double mean_displacement() const;
+
+            friend std::ostream & operator<<( std::ostream & os_, const RobinHoodHashTbl & ht_ ) {
+                for (size_type i = 0; i < ht_.m_capacity; ++i) {
+                    if ( ht_.m_dist[i] != 0 ) {
+                        os_ << "{" << ht_.m_slots[i].m_key << "," << ht_.m_slots[i].m_data << "} ";
+                    }
+                }
+                for (const auto& entry : ht_.m_overflow) {
+                    os_ << "{" << entry.m_key << "," << entry.m_data << "} ";
+                }
+                return os_;
+            }
+
+        private:
+            static constexpr size_type npos = static_cast<size_type>(-1);
+            //! Probe length (plus one) past which an entry grows the table or overflows.
+            static constexpr std::uint8_t MAX_DIST = 128;
+
+            static size_type hash_of( const KeyType & );
+            size_type find_index( const KeyType & ) const;
+            entry_type & entry_at( size_type );
+            const entry_type & entry_at( size_type ) const;
+            size_type insert_new( entry_type && );
+            size_type place( entry_type &&, bool );
+            size_type max_elements( size_type ) const;
+            size_type capacity_for( size_type ) const;
+            void allocate( size_type );
+            void release();
+            void resize( size_type );
+            void swap( RobinHoodHashTbl & );
+
+        private:
+            size_type m_capacity;     //!< Number of slots; always a power of two.
+            size_type m_count;        //!< Number of elements in the table (overflow included).
+            float m_max_load_factor;  //!< Ratio of full slots that triggers growth.
+            std::uint8_t *m_dist;     //!< Per slot: 0 if empty, else displacement from home plus one.
+            entry_type *m_slots;      //!< Raw slot storage; only slots with m_dist != 0 are constructed.
+            std::vector< entry_type > m_overflow; //!< Entries whose probe sequence reached MAX_DIST; index m_capacity + i.
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "robinhood_hashtbl.inl"
+#endif
@@ -0,0 +1,437 @@
+#include "robinhood_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::RobinHoodHashTbl(size_type sz)
+        : m_capacity{0}, m_count{0}, m_max_load_factor{0.875f}, m_dist{nullptr}, m_slots{nullptr}
+    {
+        allocate(capacity_for(sz));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::RobinHoodHashTbl(const RobinHoodHashTbl &source)
+        : m_capacity{0}, m_count{0}, m_max_load_factor{source.m_max_load_factor}, m_dist{nullptr}, m_slots{nullptr}
+    {
+        allocate(source.m_capacity);
+
+        // Mesma capacidade e mesma função hash: cada entrada fica na mesma posição
+        std::memcpy(m_dist, source.m_dist, m_capacity);
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_dist[i] != 0)
+            {
+                ::new (static_cast<void *>(m_slots + i)) entry_type(source.m_slots[i]);
+            }
+        }
+        m_overflow = source.m_overflow;
+        m_count = source.m_count;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::RobinHoodHashTbl(const std::initializer_list<entry_type> &ilist)
+        : RobinHoodHashTbl(ilist.size())
+    {
+        for (const auto &entry : ilist)
+        {
+            insert(entry.m_key, entry.m_data);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const RobinHoodHashTbl &clone)
+    {
+        if (this == &clone)
+            return *this;
+
+        RobinHoodHashTbl copy(clone);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(const std::initializer_list<entry_type> &ilist)
+    {
+        RobinHoodHashTbl copy(ilist);
+        copy.max_load_factor(m_max_load_factor);
+        swap(copy);
+
+        return *this;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::~RobinHoodHashTbl()
+    {
+        release();
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        const size_type i = find_index(key_);
+
+        if (i != npos)
+        {
+            entry_at(i).m_data = new_data_; // A chave já existe: apenas atualiza o dado
+            return false;
+        }
+
+        insert_new(entry_type(key_, new_data_));
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const size_type i = find_index(key_);
+
+        if (i != npos)
+        {
+            data_item_ = entry_at(i).m_data; // Armazena o dado encontrado na variável de saída
+            return true;
+        }
+
+        return false; // A chave não foi encontrada
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        size_type i = find_index(key_);
+
+        if (i == npos)
+            return false;
+
+        --m_count;
+        if (i >= m_capacity)
+        {
+            // Na área de transbordo a ordem não importa: a última entrada ocupa o lugar
+            std::swap(m_overflow[i - m_capacity], m_overflow.back());
+            m_overflow.pop_back();
+            return true;
+        }
+        m_slots[i].~entry_type();
+
+        // Deslocamento para trás: puxa a sequência seguinte uma posição para perto de casa,
+        // até achar um slot vazio ou uma entrada que já está na sua posição de origem.
+        const size_type mask = m_capacity - 1;
+        size_type next = (i + 1) & mask;
+        while (m_dist[next] > 1)
+        {
+            ::new (static_cast<void *>(m_slots + i)) entry_type(std::move(m_slots[next]));
+            m_slots[next].~entry_type();
+            m_dist[i] = m_dist[next] - 1;
+            i = next;
+            next = (next + 1) & mask;
+        }
+        m_dist[i] = 0;
+
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_dist[i] != 0)
+            {
+                m_slots[i].~entry_type();
+            }
+        }
+        std::memset(m_dist, 0, m_capacity);
+        m_overflow.clear();
+        m_count = 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::empty() const
+    {
+        return m_count == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        const size_type i = find_index(key_);
+
+        if (i != npos)
+        {
+            return entry_at(i).m_data;
+        }
+
+        throw std::out_of_range("Key not found in RobinHoodHashTbl");
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        size_type i = find_index(key_);
+
+        if (i == npos)
+        {
+            // Insere uma nova entrada com a chave e um valor padrão para o dado
+            i = insert_new(entry_type(key_, DataType()));
+        }
+
+        return entry_at(i).m_data;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    {
+        return find_index(key_) != npos ? 1 : 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    float RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_load_factor(float mlf)
+    {
+        // Sempre resta um slot vazio, o que encerra qualquer deslocamento para trás.
+        m_max_load_factor = std::min(std::max(mlf, 0.125f), 0.95f);
+        resize(capacity_for(m_count));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_displacement() const
+    {
+        size_type longest = 0;
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_dist[i] != 0)
+            {
+                longest = std::max<size_type>(longest, m_dist[i] - 1);
+            }
+        }
+        return longest;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    double RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::mean_displacement() const
+    {
+        // As entradas da área de transbordo não têm deslocamento e ficam de fora
+        const size_type placed = m_count - m_overflow.size();
+        if (placed == 0)
+            return 0.0;
+
+        size_type total = 0;
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (m_dist[i] != 0)
+            {
+                total += m_dist[i] - 1;
+            }
+        }
+        return static_cast<double>(total) / placed;
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::hash_of(const KeyType &key_)
+    {
+        return static_cast<size_type>(detail::mix_hash(KeyHash()(key_)));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_index(const KeyType &key_) const
+    {
+        const size_type mask = m_capacity - 1;
+        size_type i = hash_of(key_) & mask;
+
+        // Se a entrada residente está mais perto de casa do que nós estaríamos,
+        // a invariante Robin Hood garante que a chave não está na tabela.
+        for (std::uint8_t dist = 1; dist <= m_dist[i]; ++dist)
+        {
+            if (m_dist[i] == dist && KeyEqual()(m_slots[i].m_key, key_))
+            {
+                return i;
+            }
+            i = (i + 1) & mask;
+        }
+
+        // Só chaves de hash degenerado chegam à área de transbordo, quase sempre vazia
+        for (size_type k = 0; k < m_overflow.size(); ++k)
+        {
+            if (KeyEqual()(m_overflow[k].m_key, key_))
+            {
+                return m_capacity + k;
+            }
+        }
+
+        return npos;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type &
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_at(size_type i_)
+    {
+        return i_ < m_capacity ? m_slots[i_] : m_overflow[i_ - m_capacity];
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    const typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type &
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_at(size_type i_) const
+    {
+        return i_ < m_capacity ? m_slots[i_] : m_overflow[i_ - m_capacity];
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert_new(entry_type &&entry_)
+    {
+        if (m_count + 1 > max_elements(m_capacity))
+        {
+            resize(m_capacity * 2);
+        }
+
+        return place(std::move(entry_), true);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::place(entry_type &&entry_, bool may_grow_)
+    {
+        entry_type carried(std::move(entry_));
+        size_type placed = npos;
+
+        const size_type mask = m_capacity - 1;
+        size_type i = hash_of(carried.m_key) & mask;
+        std::uint8_t dist = 1;
+
+        while (true)
+        {
+            if (m_dist[i] == 0)
+            {
+                ::new (static_cast<void *>(m_slots + i)) entry_type(std::move(carried));
+                m_dist[i] = dist;
+                ++m_count;
+                return placed != npos ? placed : i;
+            }
+
+            if (m_dist[i] < dist)
+            {
+                // Rouba do rico: a entrada residente está mais perto de casa, então trocamos.
+                std::swap(carried, m_slots[i]);
+                std::swap(dist, m_dist[i]);
+                if (placed == npos)
+                    placed = i;
+            }
+
+            i = (i + 1) & mask;
+            if (++dist == MAX_DIST)
+            {
+                // Sequência longa demais. Com a tabela pela metade, crescer encurta as sequências;
+                // abaixo disso as chaves dividem o hash, e crescer não as separaria. Dentro de
+                // resize() nunca se cresce de novo.
+                if (may_grow_ && m_count >= max_elements(m_capacity) / 2)
+                {
+                    const KeyType key = placed != npos ? m_slots[placed].m_key : carried.m_key;
+                    resize(m_capacity * 2);
+                    place(std::move(carried), false);
+                    return find_index(key);
+                }
+
+                m_overflow.push_back(std::move(carried));
+                ++m_count;
+                return placed != npos ? placed : m_capacity + m_overflow.size() - 1;
+            }
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::max_elements(size_type capacity_) const
+    {
+        const auto limit = static_cast<size_type>(capacity_ * m_max_load_factor);
+        return limit < capacity_ ? limit : capacity_ - 1;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::capacity_for(size_type n_) const
+    {
+        size_type capacity = 8;
+        while (max_elements(capacity) < n_)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::allocate(size_type capacity_)
+    {
+        m_slots = std::allocator<entry_type>().allocate(capacity_);
+        m_dist = new std::uint8_t[capacity_];
+        std::memset(m_dist, 0, capacity_);
+        m_capacity = capacity_;
+        m_count = 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::release()
+    {
+        if (m_dist == nullptr)
+            return;
+
+        clear();
+        std::allocator<entry_type>().deallocate(m_slots, m_capacity);
+        delete[] m_dist;
+        m_dist = nullptr;
+        m_slots = nullptr;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::resize(size_type new_capacity_)
+    {
+        std::uint8_t *old_dist = m_dist;
+        entry_type *old_slots = m_slots;
+        const size_type old_capacity = m_capacity;
+
+        std::vector<entry_type> old_overflow;
+        old_overflow.swap(m_overflow);
+
+        allocate(new_capacity_);
+
+        // Recoloca sem crescer: resize() nunca volta a chamar a si mesma
+        for (size_type i = 0; i < old_capacity; ++i)
+        {
+            if (old_dist[i] != 0)
+            {
+                place(std::move(old_slots[i]), false);
+                old_slots[i].~entry_type();
+            }
+        }
+        for (auto &entry : old_overflow)
+        {
+            place(std::move(entry), false);
+        }
+
+        std::allocator<entry_type>().deallocate(old_slots, old_capacity);
+        delete[] old_dist;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void RobinHoodHashTbl<KeyType, DataType, KeyHash, KeyEqual>::swap(RobinHoodHashTbl &other)
+    {
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_count, other.m_count);
+        std::swap(m_max_load_factor, other.m_max_load_factor);
+        std::swap(m_dist, other.m_dist);
+        std::swap(m_slots, other.m_slots);
+        m_overflow.swap(other.m_overflow);
+    }
+} // Namespace ac.
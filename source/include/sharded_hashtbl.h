@@ -0,0 +1,106 @@
+#ifndef SHARDED_HASHTBL_H
+#define SHARDED_HASHTBL_H
+
+#include <array>        // shards
+#include <atomic>       // std::atomic
+#include <exception>    // std::exception_ptr
+#include <functional>   // std::hash, std::equal_to
+#include <mutex>        // std::unique_lock
+#include <shared_mutex> // std::shared_mutex, std::shared_lock
+#include <thread>       // std::thread
+#include <vector>       // worker threads
+
+#include "hashtbl.h"    // HashTbl
+#include "hash_utils.h" // detail::mix_hash, detail::CACHE_LINE
+
+namespace ac // Associative container
+{
+    /// Thread-safe table made of `Shards` independent HashTbl instances, each alone in its
+    /// cache lines with its own reader/writer lock. A key goes to the shard picked by the top
+    /// bits of its mixed hash, while HashTbl picks the bucket from the low bits, so the two
+    /// choices are independent. Shards grow one at a time, each under its own lock: there is
+    /// never a pause to rehash the whole table, and writers on different shards never meet.
+    ///
+    /// Every operation copies data in or out; update() runs a function on the data under the
+    /// shard's lock, and for_each_shard() hands whole shards to a function, possibly from
+    /// several threads. size() adds per-shard counters and takes no lock.
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType >,
+              std::size_t Shards = 16 >
+    class ShardedHashTbl {
+            static_assert( Shards > 0 && (Shards & (Shards - 1)) == 0, "the number of shards must be a power of 2" );
+
+        public:
+            // Aliases
+            using table_type = HashTbl< KeyType, DataType, KeyHash, KeyEqual >;
+            using size_type  = std::size_t;
+
+            //! Number of shards.
+            static constexpr size_type SHARDS = Shards;
+
+            /// Sizes every shard for its share of `table_sz_` buckets.
+            explicit ShardedHashTbl( size_type table_sz_ = DEFAULT_SIZE );
+            ShardedHashTbl( const ShardedHashTbl & ) = delete;
+            ShardedHashTbl& operator=( const ShardedHashTbl & ) = delete;
+
+            virtual ~ShardedHashTbl() = default;
+
+            /// Inserts, or updates the data of an existing key. Returns true on insertion.
+            bool insert( const KeyType &, const DataType & );
+            /// Inserts, or assigns `obj_` to the data of an existing key. Returns true on insertion.
+            template< class M >
+            bool insert_or_assign( const KeyType & key_, M && obj_ );
+            bool retrieve( const KeyType &, DataType & ) const;
+            bool contains( const KeyType & ) const;
+            bool erase( const KeyType & );
+            /// Calls `fn_( data )` on the data of `key_` with its shard held exclusively.
+            /// Returns false, without calling `fn_`, if the key is absent.
+            template< class Fn >
+            bool update( const KeyType & key_, Fn && fn_ );
+            /// Empties the shards one after the other.
+            void clear();
+            bool empty() const;
+            /// Sum of the per-shard counts; exact whenever no writer is running.
+            size_type size() const;
+            /// Makes room for `n_` elements, spread evenly over the shards.
+            void reserve( size_type n_ );
+            /// Shard that holds `key_`.
+            static size_type shard_of( const KeyType & key_ );
+
+            /// Calls `fn_( index, shard )` once per shard, with the shard held shared, from up
+            /// to `threads_` threads (the caller is one of them; 0 means one per hardware thread,
+            /// as in HashTbl). Shards are handed out one at a time, so uneven shards balance
+            /// out. `fn_` must not call back into the table. If `fn_` throws, no further shard
+            /// is handed out and the first exception is rethrown once every thread has stopped.
+            template< class Fn >
+            void for_each_shard( Fn && fn_, size_type threads_ = 1 ) const;
+            /// Same, with each shard held exclusively and passed by non-const reference. The
+            /// shard's count is refreshed after `fn_` returns or throws, so size() stays exact.
+            template< class Fn >
+            void for_each_shard( Fn && fn_, size_type threads_ = 1 );
+
+        private:
+            /// A shard and its lock, alone in their cache lines.
+            struct alignas( detail::CACHE_LINE ) Shard {
+                mutable std::shared_mutex lock;
+                table_type table;
+                std::atomic< size_type > count{ 0 }; //!< Cópia de table.size() para leitura sem trava.
+            };
+
+            using shared_lock    = std::shared_lock< std::shared_mutex >;
+            using exclusive_lock = std::unique_lock< std::shared_mutex >;
+
+            template< class Lock, class Self, class Fn >
+            static void visit_shards( Self & self_, Fn && fn_, size_type threads_ );
+
+        private:
+            std::array< Shard, Shards > m_shards; //!< Fragmentos independentes.
+
+            static const short DEFAULT_SIZE = 10;
+    };
+
+} // namespace ac
+#include "sharded_hashtbl.inl"
+#endif
@@ -0,0 +1,232 @@
+#include "sharded_hashtbl.h"
+
+namespace ac
+{
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::ShardedHashTbl(size_type sz)
+    {
+        const size_type per_shard = (sz + Shards - 1) / Shards;
+        for (auto &shard : m_shards)
+        {
+            shard.table.rehash(per_shard);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        Shard &shard = m_shards[shard_of(key_)];
+        exclusive_lock guard(shard.lock);
+
+        const bool inserted = shard.table.insert(key_, new_data_);
+        shard.count.store(shard.table.size(), std::memory_order_relaxed);
+        return inserted;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    template <typename M>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::insert_or_assign(const KeyType &key_, M &&obj_)
+    {
+        Shard &shard = m_shards[shard_of(key_)];
+        exclusive_lock guard(shard.lock);
+
+        const bool inserted = shard.table.insert_or_assign(key_, std::forward<M>(obj_));
+        shard.count.store(shard.table.size(), std::memory_order_relaxed);
+        return inserted;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const Shard &shard = m_shards[shard_of(key_)];
+        shared_lock guard(shard.lock);
+        return shard.table.retrieve(key_, data_item_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::contains(const KeyType &key_) const
+    {
+        const Shard &shard = m_shards[shard_of(key_)];
+        shared_lock guard(shard.lock);
+        return shard.table.contains(key_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::erase(const KeyType &key_)
+    {
+        Shard &shard = m_shards[shard_of(key_)];
+        exclusive_lock guard(shard.lock);
+
+        const bool erased = shard.table.erase(key_);
+        shard.count.store(shard.table.size(), std::memory_order_relaxed);
+        return erased;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    template <typename Fn>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::update(const KeyType &key_, Fn &&fn_)
+    {
+        Shard &shard = m_shards[shard_of(key_)];
+        exclusive_lock guard(shard.lock);
+
+        DataType *data = shard.table.find_ptr(key_);
+        if (data == nullptr)
+        {
+            return false;
+        }
+        fn_(*data);
+        return true;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    void ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::clear()
+    {
+        // Uma trava por vez: nunca há uma pausa global
+        for (auto &shard : m_shards)
+        {
+            exclusive_lock guard(shard.lock);
+            shard.table.clear();
+            shard.count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    bool ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::empty() const
+    {
+        return size() == 0;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    typename ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::size_type
+    ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::size() const
+    {
+        size_type total = 0;
+        for (const auto &shard : m_shards)
+        {
+            total += shard.count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    void ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::reserve(size_type n_)
+    {
+        const size_type per_shard = (n_ + Shards - 1) / Shards;
+        for (auto &shard : m_shards)
+        {
+            exclusive_lock guard(shard.lock);
+            shard.table.reserve(per_shard);
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    typename ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::size_type
+    ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::shard_of(const KeyType &key_)
+    {
+        // Bits altos do hash misturado; o HashTbl usa o hash original para o bucket
+        constexpr unsigned bits = __builtin_ctzll(Shards);
+        if constexpr (bits == 0)
+        {
+            return 0;
+        }
+        else
+        {
+            return static_cast<size_type>(detail::mix_hash(KeyHash()(key_)) >> (64 - bits));
+        }
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    template <typename Fn>
+    void ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::for_each_shard(Fn &&fn_, size_type threads_) const
+    {
+        visit_shards<shared_lock>(*this, fn_, threads_);
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    template <typename Fn>
+    void ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::for_each_shard(Fn &&fn_, size_type threads_)
+    {
+        visit_shards<exclusive_lock>(*this, fn_, threads_);
+    }
+
+    //=== Private members.
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual, std::size_t Shards>
+    template <typename Lock, typename Self, typename Fn>
+    void ShardedHashTbl<KeyType, DataType, KeyHash, KeyEqual, Shards>::visit_shards(Self &self_, Fn &&fn_, size_type threads_)
+    {
+        // Cada thread pega o próximo fragmento livre até acabarem
+        std::atomic<size_type> next{0};
+        std::exception_ptr error;
+        std::mutex error_lock;
+        auto worker = [&self_, &fn_, &next, &error, &error_lock]
+        {
+            try
+            {
+                for (size_type s = next.fetch_add(1, std::memory_order_relaxed); s < Shards; s = next.fetch_add(1, std::memory_order_relaxed))
+                {
+                    auto &shard = self_.m_shards[s];
+                    Lock guard(shard.lock);
+                    if constexpr (std::is_const<Self>::value)
+                    {
+                        fn_(s, shard.table);
+                    }
+                    else
+                    {
+                        // fn_ pode ter alterado o fragmento, mesmo se lançar: a contagem é refeita
+                        // ainda sob a trava em qualquer caso
+                        struct CountRefresh {
+                            decltype(shard) &target;
+                            ~CountRefresh() { target.count.store(target.table.size(), std::memory_order_relaxed); }
+                        } refresh{shard};
+                        fn_(s, shard.table);
+                    }
+                }
+            }
+            catch (...)
+            {
+                // Nenhum fragmento novo é entregue; a primeira exceção volta ao chamador
+                next.store(Shards, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        if (threads_ == 0)
+        {
+            threads_ = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+        }
+        const size_type workers = std::min(threads_, Shards);
+
+        // Junta as threads mesmo se a criação de uma delas falhar
+        struct Joiner {
+            std::vector<std::thread> pool;
+            ~Joiner()
+            {
+                for (auto &t : pool)
+                {
+                    t.join();
+                }
+            }
+        } joiner;
+        joiner.pool.reserve(workers - 1);
+        for (size_type w = 1; w < workers; ++w)
+        {
+            joiner.pool.emplace_back(worker);
+        }
+        worker();
+        for (auto &t : joiner.pool)
+        {
+            t.join();
+        }
+        joiner.pool.clear();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+} // Namespace ac.
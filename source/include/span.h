@@ -0,0 +1,45 @@
+#ifndef AC_SPAN_H
+#define AC_SPAN_H
+
+#include <cstddef>      // size_t
+#include <iterator>     // std::data, std::size
+#include <type_traits>  // std::enable_if_t, std::is_convertible
+#include <utility>      // std::declval
+
+namespace ac // Associative container
+{
+    /// Non-owning view of a contiguous sequence, the subset of C++20's std::span that the
+    /// batch interfaces need. Built from a pointer and a length, or from any container with
+    /// data() and size() (std::vector, std::array, a C array).
+    template< class T >
+    class span {
+        public:
+            using element_type = T;
+            using size_type    = std::size_t;
+            using iterator     = T *;
+
+            constexpr span() noexcept = default;
+            constexpr span( T * data_, size_type size_ ) noexcept : m_data{ data_ }, m_size{ size_ } {}
+
+            /// Only when the container's elements are `T` (or `T` without const).
+            template< class Container,
+                      class U = std::remove_pointer_t< decltype( std::data( std::declval<Container &>() ) ) >,
+                      class = std::enable_if_t< std::is_convertible< U (*)[], T (*)[] >::value > >
+            constexpr span( Container & c_ ) noexcept : m_data{ std::data( c_ ) }, m_size{ std::size( c_ ) } {}
+
+            constexpr T * data() const noexcept { return m_data; }
+            constexpr size_type size() const noexcept { return m_size; }
+            constexpr bool empty() const noexcept { return m_size == 0; }
+            constexpr T & operator[]( size_type i_ ) const { return m_data[i_]; }
+            constexpr iterator begin() const noexcept { return m_data; }
+            constexpr iterator end() const noexcept { return m_data + m_size; }
+
+            /// The `count_` elements starting at `offset_`.
+            constexpr span subspan( size_type offset_, size_type count_ ) const { return span( m_data + offset_, count_ ); }
+
+        private:
+            T * m_data{ nullptr };
+            size_type m_size{ 0 };
+    };
+} // namespace ac
+#endif
@@ -2,16 +2,96 @@
 #include <functional>           // std::function
 #include <algorithm>            // std::min_element
 #include <array>
+#include <atomic>
 #include <map>
+#include <set>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "../googletest-main/googletest/include/gtest/gtest.h"        // gtest lib
 #include "../include/hashtbl.h"   // header file for tested functions
+#include "../include/flat_hashtbl.h"
+#include "../include/robinhood_hashtbl.h"
+#include "../include/cuckoo_hashtbl.h"
+#include "../include/dense_hashtbl.h"
+#include "../include/concurrent_hashtbl.h"
+#include "../include/read_mostly_hashtbl.h"
+#include "../include/lock_free_hashtbl.h"
+#include "../include/atomic_hashtbl.h"
+#include "../include/sharded_hashtbl.h"
 #include "../driver/account.h"  // To get the account class
 
+// ============================================================================
+// Containers under test
+// ============================================================================
+
+/// Each engine binds a hash table implementation to the key/data types a test needs.
+struct ChainedEngine {
+    static constexpr const char* name = "Chained";
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::HashTbl< K, D, H, E >;
+};
+
+/// The chained table with a non-default bucket index mapping.
+template < class IndexPolicy >
+struct ChainedIndexEngine {
+    static std::string name;
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::HashTbl< K, D, H, E, IndexPolicy >;
+};
+template <> std::string ChainedIndexEngine< ac::FastModPolicy >::name = "ChainedFastMod";
+template <> std::string ChainedIndexEngine< ac::FibonacciPolicy >::name = "ChainedFibonacci";
+template <> std::string ChainedIndexEngine< ac::HighBitsPolicy >::name = "ChainedHighBits";
+
+struct FlatEngine {
+    static constexpr const char* name = "Flat";
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::FlatHashTbl< K, D, H, E >;
+};
+
+struct RobinHoodEngine {
+    static constexpr const char* name = "RobinHood";
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::RobinHoodHashTbl< K, D, H, E >;
+};
+
+struct CuckooEngine {
+    static constexpr const char* name = "Cuckoo";
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::CuckooHashTbl< K, D, H, E >;
+};
+
+struct DenseEngine {
+    static constexpr const char* name = "Dense";
+    template < class K, class D, class H = std::hash< K >, class E = std::equal_to< K > >
+    using table = ac::DenseHashTbl< K, D, H, E >;
+};
+
+/// The table type an engine provides for the given key/data types.
+template < typename Engine, typename... Args >
+using table_t = typename Engine::template table< Args... >;
+
+using Engines = ::testing::Types< ChainedEngine,
+                                  ChainedIndexEngine< ac::FastModPolicy >,
+                                  ChainedIndexEngine< ac::FibonacciPolicy >,
+                                  ChainedIndexEngine< ac::HighBitsPolicy >,
+                                  FlatEngine, RobinHoodEngine, CuckooEngine, DenseEngine >;
+
+class EngineNames {
+    public:
+        template < typename Engine >
+        static std::string GetName( int ) { return Engine::name; }
+};
+
 // ============================================================================
 // Test Fxture
 // ============================================================================
 
+template < typename Engine >
 class HTTest : public ::testing::Test {
     public:
         // Infrastructure to help the tests.
@@ -19,7 +99,7 @@ class HTTest : public ::testing::Test {
         Account target; //!< Target account to search for.
 
         /// This is the hash table we use in the tests.
-        ac::HashTbl< Account::AcctKey, Account, KeyHash, KeyEqual > ht_accounts{ 4 };
+        table_t< Engine, Account::AcctKey, Account, KeyHash, KeyEqual > ht_accounts{ 4 };
 
     protected:
         void SetUp() override {
@@ -41,83 +121,88 @@ class HTTest : public ::testing::Test {
         void insert_accounts();
 };
 
-void HTTest::insert_accounts( void )
+template < typename Engine >
+void HTTest< Engine >::insert_accounts( void )
 {
     // Inserindo as contas na tabela hash.
     for( auto & e : m_accounts )
         ht_accounts.insert( e.getKey(), e );
 }
 
+TYPED_TEST_SUITE( HTTest, Engines, EngineNames );
+
+/// Tests that depend on how the chained table distributes keys over its buckets.
+using ChainedHTTest = HTTest< ChainedEngine >;
 
 // ============================================================================
 // TESTING HASH TABLE
 // ============================================================================
 
-TEST_F(HTTest, InitialState)
+TYPED_TEST(HTTest, InitialState)
 {
-    ASSERT_TRUE( ht_accounts.empty() );
-    ASSERT_EQ( ht_accounts.size(), 0 );
+    ASSERT_TRUE( this->ht_accounts.empty() );
+    ASSERT_EQ( this->ht_accounts.size(), 0 );
 }
 
-TEST_F(HTTest, InsertingData)
+TYPED_TEST(HTTest, InsertingData)
 {
     Account temp;
     size_t i(0);
     // Inserindo as contas na tabela hash.
-    for( auto & e : m_accounts )
+    for( auto & e : this->m_accounts )
     {
-        ht_accounts.insert( e.getKey(), e );
-        ASSERT_EQ( ++i, ht_accounts.size() );
+        this->ht_accounts.insert( e.getKey(), e );
+        ASSERT_EQ( ++i, this->ht_accounts.size() );
         //std::cout << ">>> Inserindo \"" << e.m_name << "\"\n";
-        //std::cout << ">>> Tabela Hash de Contas depois da insercao: \n" << ht_accounts << std::endl;
+        //std::cout << ">>> Tabela Hash de Contas depois da insercao: \n" << this->ht_accounts << std::endl;
         // Unit test for insertion
-        ht_accounts.retrieve( e.getKey(), temp );
+        this->ht_accounts.retrieve( e.getKey(), temp );
         ASSERT_EQ( temp, e );
     }
 }
 
-TEST_F(HTTest, OperatorSquareBraketsRHS)
+TYPED_TEST(HTTest, OperatorSquareBraketsRHS)
 {
-    insert_accounts();
+    this->insert_accounts();
 
     // Retrieve each element
-    for( auto & e : m_accounts )
-        ASSERT_EQ( ht_accounts[e.getKey()], e );
+    for( auto & e : this->m_accounts )
+        ASSERT_EQ( this->ht_accounts[e.getKey()], e );
 }
 
-TEST_F(HTTest, OperatorSquareBraketsLHS)
+TYPED_TEST(HTTest, OperatorSquareBraketsLHS)
 {
-    insert_accounts();
+    this->insert_accounts();
 
-    auto curr_size = ht_accounts.size();
+    auto curr_size = this->ht_accounts.size();
     // Change the data in the table.
     auto i{10};
-    for( auto & e : m_accounts )
+    for( auto & e : this->m_accounts )
     {
-        auto x = ht_accounts[e.getKey()] ;
+        auto x = this->ht_accounts[e.getKey()] ;
         x.m_balance = 100.+i;
         i+= 10;
-        ht_accounts[e.getKey()] = x;
+        this->ht_accounts[e.getKey()] = x;
     }
     // The table size should be the same.
-    ASSERT_EQ( curr_size, ht_accounts.size() );
+    ASSERT_EQ( curr_size, this->ht_accounts.size() );
 
     i=10;
     // Check the table if the changes took place.
-    for( auto & e : m_accounts )
+    for( auto & e : this->m_accounts )
     {
-        auto x = ht_accounts[e.getKey()] ;
+        auto x = this->ht_accounts[e.getKey()] ;
         ASSERT_EQ ( x.m_balance, 100.+i );
         i+= 10;
     }
 }
 
-TEST_F(HTTest, OperatorSquareBraketsLHS2)
+TYPED_TEST(HTTest, OperatorSquareBraketsLHS2)
 {
     // count the number of occurrences of each word
     // (the first call to operator[] initialized the counter with zero)
     std::map<std::string, size_t> expected;
-    ac::HashTbl<std::string, size_t>  word_map;
+    table_t<TypeParam, std::string, size_t>  word_map;
     for (const auto &w : { "this", "sentence", "is", "not", "a", "sentence",
                            "this", "sentence", "is", "a", "hoax"})
     {
@@ -137,47 +222,47 @@ TEST_F(HTTest, OperatorSquareBraketsLHS2)
     ASSERT_TRUE( entered );
 }
 
-TEST_F(HTTest, AtRHS)
+TYPED_TEST(HTTest, AtRHS)
 {
-    insert_accounts();
+    this->insert_accounts();
 
     // Retrieve each element
-    for( auto & e : m_accounts )
-        ASSERT_EQ( ht_accounts.at(e.getKey()), e );
+    for( auto & e : this->m_accounts )
+        ASSERT_EQ( this->ht_accounts.at(e.getKey()), e );
 }
 
-TEST_F(HTTest, AtLHS)
+TYPED_TEST(HTTest, AtLHS)
 {
-    insert_accounts();
+    this->insert_accounts();
 
-    auto curr_size = ht_accounts.size();
+    auto curr_size = this->ht_accounts.size();
     // Change the data in the table.
     auto i{10};
-    for( auto & e : m_accounts )
+    for( auto & e : this->m_accounts )
     {
-        auto x = ht_accounts.at(e.getKey()) ;
+        auto x = this->ht_accounts.at(e.getKey()) ;
         x.m_balance = 100.+i;
         i+= 10;
-        ht_accounts.at(e.getKey()) = x;
+        this->ht_accounts.at(e.getKey()) = x;
     }
-    ASSERT_EQ( curr_size, ht_accounts.size() );
+    ASSERT_EQ( curr_size, this->ht_accounts.size() );
 
     i=10;
     // Check the table if the changes took place.
-    for( auto & e : m_accounts )
+    for( auto & e : this->m_accounts )
     {
-        auto x = ht_accounts.at(e.getKey()) ;
+        auto x = this->ht_accounts.at(e.getKey()) ;
         ASSERT_EQ ( x.m_balance, 100.+i );
         i+= 10;
     }
 }
 
-TEST_F(HTTest, AtLHS2)
+TYPED_TEST(HTTest, AtLHS2)
 {
     // count the number of occurrences of each word
     // (the first call to operator[] initialized the counter with zero)
     std::map<std::string, size_t> expected;
-    ac::HashTbl<std::string, size_t>  word_map;
+    table_t<TypeParam, std::string, size_t>  word_map;
     for (const auto &w : { "this", "sentence", "is", "not", "a", "sentence",
                            "this", "sentence", "is", "a", "hoax"})
     {
@@ -204,11 +289,11 @@ TEST_F(HTTest, AtLHS2)
     ASSERT_TRUE( entered );
 }
 
-TEST_F(HTTest, AtException)
+TYPED_TEST(HTTest, AtException)
 {
     // count the number of occurrences of each word
     // (the first call to operator[] initialized the counter with zero)
-    ac::HashTbl<std::string, size_t>  word_map;
+    table_t<TypeParam, std::string, size_t>  word_map;
     for (const auto &w : { "this", "sentence", "is", "not", "a", "sentence",
                            "this", "sentence", "is", "a", "hoax"})
     {
@@ -225,7 +310,7 @@ TEST_F(HTTest, AtException)
     }
 }
 
-TEST_F(HTTest, CopyConstructor)
+TYPED_TEST(HTTest, CopyConstructor)
 {
     std::map<std::string, size_t> expected;
     for (const auto &w : { "this", "sentence", "is", "not", "a", "sentence",
@@ -234,12 +319,12 @@ TEST_F(HTTest, CopyConstructor)
         ++expected[w];
     }
     // Make this hash have the same elements as the map.
-    ac::HashTbl<std::string, size_t>  word_map;
+    table_t<TypeParam, std::string, size_t>  word_map;
     for( const auto &e : expected )
         word_map.insert( e.first, e.second );
 
     // Create a copy
-    ac::HashTbl<std::string, size_t>  copy( word_map );
+    table_t<TypeParam, std::string, size_t>  copy( word_map );
 
     // Make sure they have the same elements with the same information.
     for( const auto &e : expected )
@@ -254,9 +339,9 @@ TEST_F(HTTest, CopyConstructor)
     ASSERT_EQ( expected.size(), copy.size() );
 }
 
-TEST_F(HTTest, ConstructorInitializer)
+TYPED_TEST(HTTest, ConstructorInitializer)
 {
-    ac::HashTbl<char, int> htables {{'a', 27}, {'b', 3}, {'c', 1}};
+    table_t<TypeParam, char, int> htables {{'a', 27}, {'b', 3}, {'c', 1}};
     std::map<char, int> expected {{'a', 27}, {'b', 3}, {'c', 1}};
 
     // Make sure they have the same elements with the same information.
@@ -271,10 +356,10 @@ TEST_F(HTTest, ConstructorInitializer)
     ASSERT_EQ( htables.size(), expected.size() );
 }
 
-TEST_F(HTTest, AssignmentOperator)
+TYPED_TEST(HTTest, AssignmentOperator)
 {
-    ac::HashTbl<char, int> htable {{'a', 27}, {'b', 3}, {'c', 1}};
-    ac::HashTbl<char, int> htable_copy;
+    table_t<TypeParam, char, int> htable {{'a', 27}, {'b', 3}, {'c', 1}};
+    table_t<TypeParam, char, int> htable_copy;
     std::map<char, int> expected {{'a', 27}, {'b', 3}, {'c', 1}};
 
     // Make sure they are different
@@ -301,9 +386,9 @@ TEST_F(HTTest, AssignmentOperator)
     ASSERT_EQ( htable_copy.size(), expected.size() );
 }
 
-TEST_F(HTTest, AssignmentInitializer)
+TYPED_TEST(HTTest, AssignmentInitializer)
 {
-    ac::HashTbl<char, int> htable {{'x', 27}, {'y', 3}, {'w', 1}};
+    table_t<TypeParam, char, int> htable {{'x', 27}, {'y', 3}, {'w', 1}};
     std::map<char, int> expected {{'a', 27}, {'b', 3}, {'c', 1}};
 
     // Make sure they are different
@@ -326,9 +411,9 @@ TEST_F(HTTest, AssignmentInitializer)
     }
 }
 
-TEST_F(HTTest, Insert)
+TYPED_TEST(HTTest, Insert)
 {
-    ac::HashTbl<char, int> htable( 3 );
+    table_t<TypeParam, char, int> htable( 3 );
     std::map<char, int> expected {{'x', 27}, {'y', 3}, {'w', 1}, {'a', 21}, {'b', 6}, {'c', 11}};
 
     ASSERT_TRUE( htable.empty() );
@@ -350,9 +435,9 @@ TEST_F(HTTest, Insert)
     }
 }
 
-TEST_F(HTTest, InsertExisting)
+TYPED_TEST(HTTest, InsertExisting)
 {
-    ac::HashTbl<char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
+    table_t<TypeParam, char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
     std::map<char, int> expected {{'x', 27}, {'y', 3}, {'w', 1}, {'a', 21}, {'b', 6}, {'c', 11}};
 
     // Make sure the two hash tables store different values.
@@ -384,9 +469,9 @@ TEST_F(HTTest, InsertExisting)
     }
 }
 
-TEST_F(HTTest, Retrieve)
+TYPED_TEST(HTTest, Retrieve)
 {
-    ac::HashTbl<char, int> htable{{'x', 27}, {'y', 3}, {'w', 1}, {'a', 21}, {'b', 6}, {'c', 11}};
+    table_t<TypeParam, char, int> htable{{'x', 27}, {'y', 3}, {'w', 1}, {'a', 21}, {'b', 6}, {'c', 11}};
     std::map<char, int> expected {{'x', 27}, {'y', 3}, {'w', 1}, {'a', 21}, {'b', 6}, {'c', 11}};
     std::map<char, int> unexpected {{'s', 27}, {'e', 3}, {'g', 1}, {'q', 21}, {'i', 6}, {'j', 11}};
 
@@ -407,9 +492,9 @@ TEST_F(HTTest, Retrieve)
     }
 }
 
-TEST_F(HTTest, EraseExisting)
+TYPED_TEST(HTTest, EraseExisting)
 {
-    ac::HashTbl<char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
+    table_t<TypeParam, char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
     std::map<char, int> expected {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
 
     // Make sure the two hash tables store different values.
@@ -431,9 +516,9 @@ TEST_F(HTTest, EraseExisting)
     ASSERT_TRUE( htable.empty() );
 }
 
-TEST_F(HTTest, EraseNonExisting)
+TYPED_TEST(HTTest, EraseNonExisting)
 {
-    ac::HashTbl<char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
+    table_t<TypeParam, char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
     std::map<char, int> expected {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
     std::map<char, int> unexpected {{'s', 27}, {'e', 3}, {'g', 1}, {'q', 21}, {'i', 6}, {'j', 11}};
 
@@ -456,9 +541,9 @@ TEST_F(HTTest, EraseNonExisting)
     }
 }
 
-TEST_F(HTTest, Clear)
+TYPED_TEST(HTTest, Clear)
 {
-    ac::HashTbl<char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
+    table_t<TypeParam, char, int> htable {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
 
     auto curr_size = htable.size();
     ASSERT_FALSE( htable.empty() );
@@ -470,9 +555,9 @@ TEST_F(HTTest, Clear)
     ASSERT_EQ( htable.size(), 0 );
 }
 
-TEST_F(HTTest, Rehash)
+TYPED_TEST(HTTest, Rehash)
 {
-    ac::HashTbl<char, int> htable (2);
+    table_t<TypeParam, char, int> htable (2);
     std::map<char, int> set1 {{'x', 2}, {'y', 1}, {'w', 4}, {'a', 5}, {'b', 8}, {'c', 7}};
     std::map<char, int> set2 {{'s', 27}, {'e', 3}, {'g', 1}, {'q', 21}, {'i', 6}, {'j', 11}};
 
@@ -510,7 +595,7 @@ TEST_F(HTTest, Rehash)
 }
 
 
-TEST_F(HTTest, Count)
+TEST_F(ChainedHTTest, Count)
 {
     ac::HashTbl<int, std::string> htable (9);
     std::map<int, std::string> set1 {{11, "eleven"}, {2*11, "twenty two"}, {3*11, "thirty three"}, {4*11, "fourty four"} };
@@ -545,6 +630,1405 @@ TEST_F(HTTest, Count)
     //std::cout << "The table: \n" << htable << std::endl;
 }
 
+TEST(IndexPolicyTest, FastModMatchesModulo)
+{
+    // Ladder rungs use the precomputed constant, other sizes compute their own.
+    for ( std::size_t size : { 2UL, 3UL, 11UL, 1009UL, 1000003UL, 4294967291UL, 7240280573005008577UL } )
+    {
+        ac::FastModPolicy policy;
+        policy.reset( size );
+        for ( std::size_t h : { 0UL, 1UL, 11UL, 12345UL, 4294967295UL, 18446744073709551557UL, ~0UL } )
+            ASSERT_EQ( policy.index( h ), h % size );
+    }
+}
+
+TEST(IndexPolicyTest, PrimeLadder)
+{
+    // Requests round up to the next rung; each rung more than doubles the previous one.
+    ASSERT_EQ( ac::PrimeModPolicy::bucket_count( 4 ), 5 );
+    ASSERT_EQ( ac::PrimeModPolicy::bucket_count( 9 ), 11 );
+    ASSERT_EQ( ac::PrimeModPolicy::bucket_count( 11 ), 11 );
+    ASSERT_EQ( ac::PrimeModPolicy::bucket_count( 2*11 ), 23 );
+    for ( std::size_t i = 1; i < ac::detail::PRIME_LADDER_SIZE; ++i )
+    {
+        const auto prime = ac::detail::PRIME_LADDER[i].prime;
+        ASSERT_GT( prime, 2 * ac::detail::PRIME_LADDER[i-1].prime );
+        ASSERT_TRUE( ac::detail::is_prime( prime ) );
+    }
+}
+
+TEST(IndexPolicyTest, PowerOfTwoIndicesInRange)
+{
+    ac::FibonacciPolicy fib;
+    ac::HighBitsPolicy high;
+    auto size = ac::FibonacciPolicy::bucket_count( 1000 );
+    ASSERT_EQ( size, 1024 );
+    fib.reset( size );
+    high.reset( size );
+
+    std::array<bool, 1024> used{};
+    for ( std::size_t h = 0; h < 1024; ++h )
+    {
+        ASSERT_LT( fib.index( h ), size );
+        ASSERT_LT( high.index( h * 0x9E3779B97F4A7C15ULL ), size );
+        used[ fib.index( h ) ] = true;
+    }
+    // Fibonacci hashing spreads consecutive keys over most of the buckets.
+    ASSERT_GT( std::count( used.begin(), used.end(), true ), 600 );
+
+    // Requests past the largest power of two saturate, as the prime ladder does.
+    const std::size_t top = std::size_t{1} << 63;
+    ASSERT_EQ( ac::FibonacciPolicy::bucket_count( top ), top );
+    ASSERT_EQ( ac::FibonacciPolicy::bucket_count( top + 1 ), top );
+    ASSERT_EQ( ac::HighBitsPolicy::bucket_count( ~std::size_t{0} ), top );
+}
+
+TEST(RobinHoodTest, EraseInsertChurn)
+{
+    ac::RobinHoodHashTbl<int, int> htable;
+    for ( int i = 0; i < 1000; ++i )
+        htable.insert( i, i );
+
+    auto max_disp = htable.max_displacement();
+    auto mean_disp = htable.mean_displacement();
+
+    // Erasing and re-inserting the same keys must not leave anything behind.
+    for ( int round = 0; round < 50; ++round )
+    {
+        for ( int i = 0; i < 1000; i += 2 )
+            ASSERT_TRUE( htable.erase( i ) );
+        for ( int i = 0; i < 1000; i += 2 )
+            ASSERT_TRUE( htable.insert( i, round ) );
+    }
+
+    ASSERT_EQ( htable.size(), 1000 );
+    ASSERT_EQ( htable.max_displacement(), max_disp );
+    ASSERT_DOUBLE_EQ( htable.mean_displacement(), mean_disp );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_EQ( htable.at( i ), i % 2 == 0 ? 49 : i );
+}
+
+/// Sends every negative key to the same hash, as a broken or hostile KeyHash would.
+struct NegativesCollide {
+    std::size_t operator()( int k ) const { return k < 0 ? 0 : std::hash<int>()( k ); }
+};
+
+TEST(RobinHoodTest, DegenerateHashOverflows)
+{
+    // Doubling cannot separate keys with one hash: past MAX_DIST they overflow instead of
+    // growing the table without bound.
+    ac::RobinHoodHashTbl<int, int, NegativesCollide> htable;
+    for ( int i = 1; i <= 500; ++i )
+        ASSERT_TRUE( htable.insert( -i, i ) );
+    for ( int i = 0; i < 2000; ++i )
+        ASSERT_TRUE( htable.insert( i, i ) );
+    ASSERT_EQ( htable.size(), 2500u );
+    ASSERT_LT( htable.max_displacement(), 128u );
+    for ( int i = 1; i <= 500; ++i )
+        ASSERT_EQ( htable.at( -i ), i );
+
+    // Erase, update and copy reach the overflowed entries too.
+    for ( int i = 1; i <= 500; i += 2 )
+        ASSERT_TRUE( htable.erase( -i ) );
+    htable[ -2 ] = -2;
+    ASSERT_FALSE( htable.insert( -4, -4 ) );
+    ac::RobinHoodHashTbl<int, int, NegativesCollide> copy( htable );
+    ASSERT_EQ( copy.size(), 2250u );
+    for ( int i = 1; i <= 500; ++i )
+    {
+        ASSERT_EQ( copy.count( -i ), i % 2 == 0 ? 1u : 0u );
+    }
+    ASSERT_EQ( copy.at( -2 ), -2 );
+    ASSERT_EQ( copy.at( -4 ), -4 );
+    ASSERT_EQ( copy.at( -6 ), 6 );
+    for ( int i = 0; i < 2000; ++i )
+        ASSERT_EQ( copy.at( i ), i );
+
+    // Growing for the load re-places everything, the overflow included.
+    copy.max_load_factor( 0.5f );
+    ASSERT_EQ( copy.size(), 2250u );
+    ASSERT_EQ( copy.at( -500 ), 500 );
+    copy.clear();
+    ASSERT_TRUE( copy.empty() );
+    ASSERT_FALSE( copy.erase( -2 ) );
+}
+
+TEST(CuckooTest, HighLoadFactor)
+{
+    ac::CuckooHashTbl<int, int> htable;
+    htable.max_load_factor( 0.98f );
+
+    // Near the load limit most inserts need eviction paths or the stash.
+    for ( int i = 0; i < 20000; ++i )
+        ASSERT_TRUE( htable.insert( i, 2*i ) );
+    for ( int i = 0; i < 20000; i += 3 )
+        ASSERT_TRUE( htable.erase( i ) );
+
+    for ( int i = 0; i < 20000; ++i )
+    {
+        int data;
+        ASSERT_EQ( htable.retrieve( i, data ), i % 3 != 0 );
+        if ( i % 3 != 0 )
+        {
+            ASSERT_EQ( data, 2*i );
+        }
+    }
+}
+
+TEST(CuckooTest, StashStaysBounded)
+{
+    // Every negative key shares one hash: no eviction path, growth or new seed can place
+    // more than two buckets and the stash hold, so the insert throws instead of growing.
+    ac::CuckooHashTbl<int, int, NegativesCollide> htable;
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.insert( i, i ) );
+
+    int placed = 0;
+    while ( placed < 100 )
+    {
+        try
+        {
+            ASSERT_TRUE( htable.insert( -( placed + 1 ), placed + 1 ) );
+        }
+        catch ( const std::length_error & )
+        {
+            break;
+        }
+        ++placed;
+    }
+    ASSERT_GE( placed, 4 );
+    ASSERT_LE( placed, 12 );
+
+    // The failed insert left the table as it was.
+    ASSERT_EQ( htable.size(), 1000u + placed );
+    ASSERT_EQ( htable.count( -( placed + 1 ) ), 0u );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_EQ( htable.at( i ), i );
+    for ( int i = 1; i <= placed; ++i )
+        ASSERT_EQ( htable.at( -i ), i );
+
+    // Erasing a colliding key makes room for another one.
+    ASSERT_TRUE( htable.erase( -1 ) );
+    ASSERT_TRUE( htable.insert( -( placed + 1 ), 0 ) );
+    ac::CuckooHashTbl<int, int, NegativesCollide> copy( htable );
+    ASSERT_EQ( copy.size(), htable.size() );
+    ASSERT_EQ( copy.at( -( placed + 1 ) ), 0 );
+}
+
+TEST(IncrementalRehashTest, LookupsDuringMigration)
+{
+    ac::HashTbl<int, int> htable;
+    htable.incremental_rehash( true, 1 );
+    ASSERT_TRUE( htable.incremental_rehash() );
+
+    // One bucket migrates per operation, so most of these inserts run mid-migration.
+    bool saw_migration = false;
+    for ( int i = 0; i < 5000; ++i )
+    {
+        ASSERT_TRUE( htable.insert( i, 2*i ) );
+        saw_migration = saw_migration || htable.rehashing();
+    }
+    ASSERT_TRUE( saw_migration );
+    ASSERT_EQ( htable.size(), 5000u );
+
+    for ( int i = 0; i < 5000; i += 2 )
+        ASSERT_TRUE( htable.erase( i ) );
+
+    // A copy taken mid-migration must see every surviving entry.
+    ac::HashTbl<int, int> copy( htable );
+    for ( int i = 0; i < 5000; ++i )
+    {
+        int data;
+        ASSERT_EQ( htable.retrieve( i, data ), i % 2 != 0 );
+        ASSERT_EQ( copy.retrieve( i, data ), i % 2 != 0 );
+        if ( i % 2 != 0 )
+        {
+            ASSERT_EQ( data, 2*i );
+            ASSERT_EQ( htable.at( i ), 2*i );
+        }
+    }
+
+    // Turning the mode off finishes the pending migration.
+    htable.incremental_rehash( false );
+    ASSERT_FALSE( htable.rehashing() );
+    ASSERT_EQ( htable.size(), 2500u );
+
+    htable.clear();
+    ASSERT_TRUE( htable.empty() );
+    ASSERT_THROW( htable.at( 1 ), std::out_of_range );
+}
+
+TEST(GrowthPolicyTest, GrowsOnMaxLoadFactor)
+{
+    ac::HashTbl<int, int> htable;
+    htable.max_load_factor( 0.5f );
+    ASSERT_FLOAT_EQ( htable.max_load_factor(), 0.5f );
+
+    for ( int i = 0; i < 1000; ++i )
+    {
+        htable.insert( i, i );
+        ASSERT_LE( htable.load_factor(), 0.5f );
+    }
+
+    // Lowering the limit below the current load resizes right away.
+    htable.max_load_factor( 0.25f );
+    ASSERT_LE( htable.load_factor(), 0.25f );
+}
+
+TEST(GrowthPolicyTest, ReserveAndRehash)
+{
+    ac::HashTbl<int, int> htable;
+    htable.reserve( 5000 );
+    const auto buckets = htable.bucket_count();
+    ASSERT_GE( buckets, 5000u );
+
+    for ( int i = 0; i < 5000; ++i )
+        htable.insert( i, i );
+    ASSERT_EQ( htable.bucket_count(), buckets ); // Presized: no growth on the way.
+
+    htable.reserve( 10 ); // Never shrinks.
+    ASSERT_EQ( htable.bucket_count(), buckets );
+
+    for ( int i = 0; i < 4900; ++i )
+        htable.erase( i );
+    htable.rehash( 0 ); // Shrink to fit.
+    ASSERT_LT( htable.bucket_count(), buckets );
+    ASSERT_GE( htable.bucket_count(), 100u );
+    for ( int i = 4900; i < 5000; ++i )
+        ASSERT_EQ( htable.at( i ), i );
+}
+
+TEST(GrowthPolicyTest, ShrinkWithHysteresis)
+{
+    ac::HashTbl<int, int, std::hash<int>, std::equal_to<int>, ac::PrimeModPolicy, ac::ShrinkingPolicy> htable;
+    for ( int i = 0; i < 4096; ++i )
+        htable.insert( i, i );
+    const auto grown = htable.bucket_count();
+
+    for ( int i = 0; i < 4000; ++i )
+        htable.erase( i );
+    ASSERT_LT( htable.bucket_count(), grown );
+    ASSERT_GE( htable.load_factor(), 0.25f );
+
+    // Right after a shrink, an insert/erase cycle must not resize again.
+    const auto shrunk = htable.bucket_count();
+    for ( int i = 0; i < 100; ++i )
+    {
+        htable.insert( -1, 0 );
+        htable.erase( -1 );
+    }
+    ASSERT_EQ( htable.bucket_count(), shrunk );
+    for ( int i = 4000; i < 4096; ++i )
+        ASSERT_EQ( htable.at( i ), i );
+}
+
+TEST(StoredHashTest, TraitAndCollisions)
+{
+    static_assert( !ac::store_hash<int>::value && !ac::store_hash<const char*>::value, "cheap keys" );
+    static_assert( ac::store_hash<std::string>::value && ac::store_hash<Account::AcctKey>::value, "costly keys" );
+
+    // Every key lands in the same bucket: the cached hashes tell them apart before KeyEqual.
+    struct ModHash { std::size_t operator()( const std::string & s ) const { return s.size() * 7; } };
+    ac::HashTbl<std::string, int, ModHash> htable;
+    for ( int i = 0; i < 500; ++i )
+        ASSERT_TRUE( htable.insert( std::to_string( i ), i ) );
+    for ( int i = 0; i < 500; ++i )
+        ASSERT_EQ( htable.at( std::to_string( i ) ), i );
+    ASSERT_FALSE( htable.erase( "-1" ) );
+}
+
+TEST(PoolAllocatorTest, RecyclesAndReleases)
+{
+    using pool_table = ac::HashTbl<int, std::string, std::hash<int>, std::equal_to<int>, ac::PrimeModPolicy,
+                                   ac::LoadFactorPolicy, ac::PoolAllocator<ac::HashEntry<int, std::string>>>;
+    pool_table htable;
+    for ( int i = 0; i < 10000; ++i )
+        ASSERT_TRUE( htable.insert( i, std::to_string( i ) ) );
+    const auto chunks = htable.get_allocator().chunks();
+    ASSERT_GT( chunks, 0u );
+
+    // Erased nodes go back to the free list: churn allocates no new chunk.
+    for ( int round = 0; round < 3; ++round )
+    {
+        for ( int i = 0; i < 10000; i += 2 )
+            ASSERT_TRUE( htable.erase( i ) );
+        for ( int i = 0; i < 10000; i += 2 )
+            ASSERT_TRUE( htable.insert( i, std::to_string( -i ) ) );
+    }
+    ASSERT_EQ( htable.get_allocator().chunks(), chunks );
+
+    // A copy owns its own pool, so clearing the source leaves it intact.
+    pool_table copy( htable );
+    ASSERT_FALSE( copy.get_allocator() == htable.get_allocator() );
+    htable.clear();
+    ASSERT_EQ( htable.get_allocator().chunks(), 0u );
+    for ( int i = 0; i < 10000; ++i )
+        ASSERT_EQ( copy.at( i ), std::to_string( i % 2 == 0 ? -i : i ) );
+
+    htable.insert( 1, "one" );
+    ASSERT_EQ( htable.at( 1 ), "one" );
+}
+
+TEST(PoolAllocatorTest, MovedFromTableSharesThePool)
+{
+    using pool_table = ac::HashTbl<int, std::string, std::hash<int>, std::equal_to<int>, ac::PrimeModPolicy,
+                                   ac::LoadFactorPolicy, ac::PoolAllocator<ac::HashEntry<int, std::string>>>;
+    static_assert( std::is_nothrow_move_constructible<pool_table>::value, "moving a pool table cannot throw" );
+    static_assert( std::is_nothrow_move_assignable<pool_table>::value, "moving a pool table cannot throw" );
+
+    pool_table source;
+    for ( int i = 0; i < 1000; ++i )
+        source.insert( i, std::to_string( i ) );
+    pool_table moved( std::move( source ) );
+
+    // The source keeps a copy of the allocator: it shares the pool, so clearing the
+    // destination must not free the chunks that hold the source's new nodes.
+    ASSERT_TRUE( moved.get_allocator() == source.get_allocator() );
+    for ( int i = 0; i < 100; ++i )
+        ASSERT_TRUE( source.insert( -i, std::to_string( -i ) ) );
+    moved.clear();
+    ASSERT_GT( moved.get_allocator().chunks(), 0u );
+    for ( int i = 0; i < 100; ++i )
+        ASSERT_EQ( source.at( -i ), std::to_string( -i ) );
+
+    // Once neither table holds a node, the chunks go back to the system.
+    source.clear();
+    ASSERT_EQ( source.get_allocator().chunks(), 0u );
+
+    pool_table assigned;
+    assigned.insert( 1, "one" );
+    assigned = std::move( moved );
+    ASSERT_TRUE( assigned.empty() );
+    ASSERT_TRUE( moved.insert( 2, "two" ) );
+    ASSERT_EQ( moved.at( 2 ), "two" );
+}
+
+TEST(DenseTest, InsertionOrderAndSwapWithLast)
+{
+    ac::DenseHashTbl<int, int> htable;
+    for ( int i = 0; i < 5; ++i )
+        htable.insert( i * 100, i );
+
+    std::ostringstream oss;
+    oss << htable;
+    ASSERT_EQ( oss.str(), "{0,0} {100,1} {200,2} {300,3} {400,4} " );
+
+    // The last entry fills the hole left by an erase.
+    ASSERT_TRUE( htable.erase( 100 ) );
+    oss.str( "" );
+    oss << htable;
+    ASSERT_EQ( oss.str(), "{0,0} {400,4} {200,2} {300,3} " );
+
+    // Churn through many growths: chains must stay consistent with the moved entries.
+    for ( int i = 0; i < 20000; ++i )
+        htable.insert( i, i );
+    for ( int i = 0; i < 20000; i += 3 )
+        ASSERT_TRUE( htable.erase( i ) );
+    for ( int i = 0; i < 20000; ++i )
+        ASSERT_EQ( htable.count( i ), i % 3 != 0 ? 1u : 0u );
+}
+
+/// Data that counts its copies, to check which operations build entries in place.
+struct CopyCounter {
+    static int copies;
+    int value;
+    explicit CopyCounter( int v = 0 ) : value{ v } {}
+    CopyCounter( const CopyCounter & other ) : value{ other.value } { ++copies; }
+    CopyCounter( CopyCounter && ) = default;
+    CopyCounter & operator=( const CopyCounter & other ) { value = other.value; ++copies; return *this; }
+    CopyCounter & operator=( CopyCounter && ) = default;
+};
+int CopyCounter::copies = 0;
+
+TEST(MoveSemanticsTest, EmplaceWithoutCopies)
+{
+    ac::HashTbl<std::string, CopyCounter> htable;
+    CopyCounter::copies = 0;
+
+    ASSERT_TRUE( htable.insert( std::string( "a" ), CopyCounter( 1 ) ) );
+    ASSERT_TRUE( htable.emplace( std::string( "b" ), CopyCounter( 2 ) ) );
+    ASSERT_TRUE( htable.try_emplace( "c", 3 ) );
+    ASSERT_TRUE( htable.insert_or_assign( "d", CopyCounter( 4 ) ) );
+    ASSERT_FALSE( htable.insert_or_assign( "d", CopyCounter( 5 ) ) );
+    for ( int i = 0; i < 100; ++i ) // Growth moves entries, it never copies them.
+        htable.try_emplace( std::to_string( i + 10 ), i );
+    ASSERT_EQ( CopyCounter::copies, 0 );
+
+    ASSERT_EQ( htable.at( "d" ).value, 5 );
+    ASSERT_FALSE( htable.emplace( std::string( "a" ), CopyCounter( 9 ) ) );
+    ASSERT_EQ( htable.at( "a" ).value, 1 );
+}
+
+TEST(MoveSemanticsTest, MoveOnlyData)
+{
+    ac::HashTbl<int, std::unique_ptr<int>> htable;
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.try_emplace( i, std::make_unique<int>( i ) ) );
+
+    // try_emplace leaves its arguments alone when the key exists.
+    auto keep = std::make_unique<int>( -1 );
+    ASSERT_FALSE( htable.try_emplace( 7, std::move( keep ) ) );
+    ASSERT_NE( keep, nullptr );
+
+    ASSERT_FALSE( htable.insert_or_assign( 7, std::move( keep ) ) );
+    ASSERT_EQ( *htable.at( 7 ), -1 );
+    htable[2000] = std::make_unique<int>( 2000 );
+
+    // The moved-from table is empty but still usable.
+    ac::HashTbl<int, std::unique_ptr<int>> moved( std::move( htable ) );
+    ASSERT_EQ( moved.size(), 1001u );
+    ASSERT_EQ( *moved.at( 999 ), 999 );
+    ASSERT_TRUE( htable.empty() );
+    ASSERT_EQ( htable.count( 1 ), 0u );
+    ASSERT_FALSE( htable.erase( 1 ) );
+    ASSERT_TRUE( htable.insert( 1, std::make_unique<int>( 1 ) ) );
+    ASSERT_EQ( *htable.at( 1 ), 1 );
+
+    htable = std::move( moved );
+    ASSERT_EQ( htable.size(), 1001u );
+    ASSERT_EQ( *htable[2000], 2000 );
+}
+
+TEST(TransparentLookupTest, StringKeys)
+{
+    ac::HashTbl<std::string, size_t, ac::StringHash, std::equal_to<>> htable;
+    for ( const char* word : { "alpha", "beta", "gamma", "beta" } )
+        htable[word]++;
+
+    // None of these builds a std::string.
+    std::string_view beta{ "beta" };
+    size_t data;
+    ASSERT_TRUE( htable.retrieve( beta, data ) );
+    ASSERT_EQ( data, 2u );
+    ASSERT_EQ( htable.at( "gamma" ), 1u );
+    ASSERT_GE( htable.count( beta ), 1u );
+    ASSERT_THROW( htable.at( std::string_view{ "delta" } ), std::out_of_range );
+    ASSERT_TRUE( htable.contains( "gamma" ) );
+    ASSERT_EQ( *htable.find_ptr( beta ), 2u );
+    ASSERT_EQ( htable.find( "delta" ), htable.end() );
+    ASSERT_TRUE( htable.erase( "alpha" ) );
+    ASSERT_FALSE( htable.erase( "alpha" ) );
+    ASSERT_EQ( htable.size(), 2u );
+}
+
+TEST(TransparentLookupTest, AccountKeyView)
+{
+    ac::HashTbl<Account::AcctKey, Account, KeyHash, KeyEqual> htable;
+    Account acct{ "Jaques Bauer", 1, 1668, 20123, 1500.f };
+    htable.insert( acct.getKey(), acct );
+
+    std::string name{ "Jaques Bauer" };
+    Account::AcctKeyView view{ name, 1, 1668, 20123 };
+    ASSERT_EQ( KeyHash()( view ), KeyHash()( acct.getKey() ) );
+    ASSERT_EQ( htable.at( view ), acct );
+    ASSERT_FALSE( htable.erase( Account::AcctKeyView{ name, 1, 1668, 0 } ) );
+    ASSERT_TRUE( htable.erase( view ) );
+    ASSERT_TRUE( htable.empty() );
+}
+
+TEST(FindTest, FindPtrAndContains)
+{
+    ac::HashTbl<int, std::string> htable;
+    htable.incremental_rehash( true, 1 );
+    for ( int i = 0; i < 1000; ++i )
+    {
+        htable.insert( i, std::to_string( i ) );
+
+        // Lookups must see entries on both sides of an ongoing migration.
+        const auto & view = htable;
+        auto it = view.find( i / 2 );
+        ASSERT_NE( it, view.end() );
+        ASSERT_EQ( it->m_key, i / 2 );
+        ASSERT_EQ( it->m_data, std::to_string( i / 2 ) );
+    }
+
+    ASSERT_TRUE( htable.contains( 999 ) );
+    ASSERT_FALSE( htable.contains( 1000 ) );
+    ASSERT_EQ( htable.find( 1000 ), htable.end() );
+    ASSERT_EQ( htable.find_ptr( -1 ), nullptr );
+
+    // find_ptr and find give write access in place.
+    *htable.find_ptr( 10 ) = "ten";
+    htable.find( 11 )->m_data = "eleven";
+    ac::HashTbl<int, std::string>::const_iterator cit = htable.find( 10 );
+    ASSERT_EQ( cit->m_data, "ten" );
+    ASSERT_EQ( htable.at( 11 ), "eleven" );
+}
+
+TEST(IterationTest, VisitsEveryEntryOnce)
+{
+    ac::HashTbl<int, int> htable( 1000 );
+    ASSERT_EQ( htable.begin(), htable.end() );
+    for ( int i = 0; i < 300; ++i )
+        htable.insert( i * 7, i );
+
+    long keys = 0, data = 0;
+    for ( const auto & entry : htable )
+    {
+        keys += entry.m_key;
+        data += entry.m_data;
+    }
+    ASSERT_EQ( keys, 7L * 299 * 300 / 2 );
+    ASSERT_EQ( data, 299L * 300 / 2 );
+    ASSERT_EQ( std::distance( htable.cbegin(), htable.cend() ), 300 );
+
+    // Writable through a non-const iterator; erasing empties buckets the bitmap must skip.
+    for ( auto it = htable.begin(); it != htable.end(); it++ )
+        it->m_data = -it->m_data;
+    for ( int i = 0; i < 300; i += 2 )
+        htable.erase( i * 7 );
+    ASSERT_EQ( std::distance( htable.begin(), htable.end() ), 150 );
+    for ( const auto & entry : htable )
+        ASSERT_EQ( entry.m_data, -entry.m_key / 7 );
+}
+
+TEST(IterationTest, DuringIncrementalMigration)
+{
+    ac::HashTbl<int, int> htable;
+    htable.incremental_rehash( true, 1 );
+    for ( int i = 0; i < 2000; ++i )
+    {
+        htable.insert( i, i );
+        if ( i % 97 == 0 )
+        {
+            // Both bucket arrays must be covered, with no entry seen twice.
+            std::set<int> seen;
+            for ( const auto & entry : htable )
+                ASSERT_TRUE( seen.insert( entry.m_key ).second );
+            ASSERT_EQ( seen.size(), htable.size() );
+        }
+    }
+}
+
+TEST(IterationTest, BucketInterface)
+{
+    ac::HashTbl<std::string, int> htable;
+    for ( int i = 0; i < 500; ++i )
+        htable.insert( "key" + std::to_string( i ), i );
+
+    std::size_t total = 0;
+    for ( std::size_t n = 0; n < htable.bucket_count(); ++n )
+    {
+        ASSERT_EQ( htable.bucket_size( n ), static_cast<std::size_t>( std::distance( htable.cbegin( n ), htable.cend( n ) ) ) );
+        for ( auto it = htable.begin( n ); it != htable.end( n ); ++it )
+        {
+            ASSERT_EQ( htable.bucket( it->m_key ), n );
+            ++total;
+        }
+    }
+    ASSERT_EQ( total, htable.size() );
+
+    const std::size_t n = htable.bucket( "key42" );
+    auto it = std::find_if( htable.begin( n ), htable.end( n ), []( const auto & e ) { return e.m_key == "key42"; } );
+    ASSERT_NE( it, htable.end( n ) );
+    ASSERT_EQ( it->m_data, 42 );
+}
+
+TEST(BatchLookupTest, MatchesScalarLookups)
+{
+    ac::HashTbl<std::string, int> htable;
+    htable.incremental_rehash( true, 1 );
+    for ( int i = 0; i < 1000; ++i )
+        htable.insert( std::to_string( i ), i );
+
+    // Hits and misses interleaved, more than one group long, with a migration in progress.
+    std::vector<std::string> keys;
+    for ( int i = 0; i < 101; ++i )
+        keys.push_back( std::to_string( i * 17 ) );
+    ASSERT_TRUE( htable.rehashing() );
+
+    std::vector<int *> out( keys.size() );
+    ASSERT_EQ( htable.retrieve_batch( keys, out ), 59u );
+    ASSERT_EQ( htable.count_batch( keys ), 59u );
+    for ( std::size_t i = 0; i < keys.size(); ++i )
+        ASSERT_EQ( out[i], htable.find_ptr( keys[i] ) );
+
+    // The pointers give write access; the const overload only reads.
+    *out[1] = -17;
+    const auto & view = htable;
+    std::vector<const int *> cout_( 2 );
+    ASSERT_EQ( view.retrieve_batch( ac::span<const std::string>( keys.data() + 1, 2 ), cout_ ), 2u );
+    ASSERT_EQ( *cout_[0], -17 );
+    ASSERT_EQ( *cout_[1], 34 );
+
+    ASSERT_EQ( htable.count_batch( {} ), 0u );
+    std::vector<int *> short_out( 3 );
+    ASSERT_THROW( htable.retrieve_batch( keys, short_out ), std::length_error );
+}
+
+TEST(BatchLookupTest, InterleavedMatchesScalar)
+{
+    // Long chains of uneven length: each lane walks as far as its own key needs.
+    ac::HashTbl<int, int> htable( 10, ac::LoadFactorPolicy( 8.0f ) );
+    htable.incremental_rehash( true, 1 );
+    for ( int i = 0; i < 3000; ++i )
+        htable.insert( i * 3, i );
+
+    std::vector<int> keys;
+    for ( int i = 0; i < 1000; ++i )
+        keys.push_back( i * 7 );
+
+    for ( std::size_t width : { 0, 1, 3, 8, 64, 1000 } )
+    {
+        std::vector<int *> out( keys.size() );
+        ASSERT_EQ( htable.interleaved_find( keys, out, width ), 334u );
+        for ( std::size_t i = 0; i < keys.size(); ++i )
+            ASSERT_EQ( out[i], htable.find_ptr( keys[i] ) );
+    }
+
+    const auto & view = htable;
+    std::vector<const int *> cout_( 1 );
+    ASSERT_EQ( view.interleaved_find( ac::span<const int>( keys.data() + 3, 1 ), cout_ ), 1u );
+    ASSERT_EQ( *cout_[0], 7 );
+    ASSERT_EQ( htable.interleaved_find( {}, {} ), 0u );
+}
+
+TEST(BulkInsertTest, RangeConstructorAndDuplicates)
+{
+    // Pairs from a std::map, through the range constructor.
+    std::map<std::string, int> source;
+    for ( int i = 0; i < 5000; ++i )
+        source[ "k" + std::to_string( i ) ] = i;
+    ac::HashTbl<std::string, int> from_map( source.begin(), source.end() );
+    ASSERT_EQ( from_map.size(), source.size() );
+    for ( const auto & p : source )
+        ASSERT_EQ( from_map.at( p.first ), p.second );
+
+    // Repeated keys, some already present: the last occurrence wins, as with insert().
+    ac::HashTbl<int, int> htable;
+    htable.insert( 7, -1 );
+    std::vector<ac::HashEntry<int, int>> entries;
+    for ( int i = 0; i < 3000; ++i )
+        entries.emplace_back( i % 1000, i );
+    ASSERT_EQ( htable.insert_bulk( entries.begin(), entries.end() ), 999u );
+    ASSERT_EQ( htable.size(), 1000u );
+    for ( int k = 0; k < 1000; ++k )
+        ASSERT_EQ( htable.at( k ), 2000 + k );
+    ASSERT_LE( htable.load_factor(), htable.max_load_factor() );
+    ASSERT_EQ( std::distance( htable.begin(), htable.end() ), 1000 );
+}
+
+TEST(BulkInsertTest, UniqueKeysAndThreads)
+{
+    std::vector<std::pair<int, std::string>> pairs;
+    for ( int i = 0; i < 20000; ++i )
+        pairs.emplace_back( i * 13, std::to_string( i ) );
+
+    for ( std::size_t threads : { 1, 3, 0 } )
+    {
+        ac::HashTbl<int, std::string> htable;
+        htable.incremental_rehash( true, 1 );
+        ASSERT_EQ( htable.insert_bulk( pairs.begin(), pairs.end(), true, threads ), pairs.size() );
+        ASSERT_EQ( htable.size(), pairs.size() );
+        ASSERT_FALSE( htable.rehashing() );
+        for ( const auto & p : pairs )
+            ASSERT_EQ( *htable.find_ptr( p.first ), p.second );
+    }
+
+    // Forward (not random-access) iterators are counted in a first pass too.
+    std::forward_list<ac::HashEntry<int, int>> list{ { 1, 10 }, { 2, 20 }, { 1, 11 } };
+    ac::HashTbl<int, int> htable( list.begin(), list.end() );
+    ASSERT_EQ( htable.size(), 2u );
+    ASSERT_EQ( htable.at( 1 ), 11 );
+}
+
+/// Hash that throws for one key.
+struct PoisonedHash {
+    static int poison;
+    std::size_t operator()( int k ) const
+    {
+        if ( k == poison )
+            throw std::runtime_error( "hash" );
+        return std::hash<int>()( k );
+    }
+};
+int PoisonedHash::poison = 1 << 30;
+
+TEST(BulkInsertTest, HashExceptionsReachTheCaller)
+{
+    ac::HashTbl<int, int, PoisonedHash> htable;
+    for ( int i = -100; i < 0; ++i )
+        htable.insert( i, i );
+    std::vector<std::pair<int, int>> pairs;
+    for ( int i = 0; i < 20000; ++i )
+        pairs.emplace_back( i, i );
+
+    // The first key is hashed by the calling thread, the last by the last worker: either
+    // way insert_bulk() throws, and nothing of the range was inserted.
+    for ( int poison : { 0, 19999 } )
+    {
+        PoisonedHash::poison = poison;
+        for ( std::size_t threads : { 1, 4 } )
+        {
+            ASSERT_THROW( htable.insert_bulk( pairs.begin(), pairs.end(), false, threads ), std::runtime_error );
+            ASSERT_EQ( htable.size(), 100u );
+            ASSERT_FALSE( htable.contains( 1 ) );
+        }
+    }
+    PoisonedHash::poison = 1 << 30;
+    for ( int i = -100; i < 0; ++i )
+        ASSERT_EQ( htable.at( i ), i );
+    ASSERT_EQ( htable.insert_bulk( pairs.begin(), pairs.end(), true, 4 ), pairs.size() );
+}
+
+TEST(ParallelRehashTest, SameChainsAsSerial)
+{
+    using Table = ac::HashTbl<std::string, int>;
+    Table serial, parallel;
+    for ( int i = 0; i < 30000; ++i )
+    {
+        serial.insert( "k" + std::to_string( i ), i );
+        parallel.insert( "k" + std::to_string( i ), i );
+    }
+
+    // Large enough for every thread to get a range of its own: each chain must come out
+    // in the order a serial rehash leaves it.
+    for ( std::size_t threads : { 3, 0 } )
+    {
+        for ( std::size_t n : { 200000, 70000 } )
+        {
+            serial.rehash( n );
+            parallel.rehash( n, threads );
+            ASSERT_EQ( parallel.bucket_count(), serial.bucket_count() );
+            ASSERT_EQ( parallel.size(), 30000u );
+            ASSERT_TRUE( std::equal( serial.begin(), serial.end(), parallel.begin(), parallel.end(),
+                                     []( const auto & a, const auto & b ) { return a.m_key == b.m_key && a.m_data == b.m_data; } ) );
+        }
+
+        Table copy( parallel, threads );
+        ASSERT_EQ( copy.size(), parallel.size() );
+        ASSERT_TRUE( std::equal( copy.begin(), copy.end(), parallel.begin(), parallel.end(),
+                                 []( const auto & a, const auto & b ) { return a.m_key == b.m_key && a.m_data == b.m_data; } ) );
+        copy.insert( "extra", -1 );
+        ASSERT_FALSE( parallel.contains( "extra" ) );
+    }
+    for ( int i = 0; i < 30000; ++i )
+        ASSERT_EQ( parallel.at( "k" + std::to_string( i ) ), i );
+
+    // A pool allocator is not thread-safe: the copy runs on the calling thread alone, while
+    // the rehash, which allocates nothing, still splits the buckets among the threads.
+    ac::HashTbl<int, int, std::hash<int>, std::equal_to<int>, ac::PrimeModPolicy,
+                ac::LoadFactorPolicy, ac::PoolAllocator<ac::HashEntry<int, int>>> pooled;
+    for ( int i = 0; i < 30000; ++i )
+        pooled.insert( i, -i );
+    pooled.rehash( 200000, 4 );
+    auto pooled_copy( pooled );
+    decltype( pooled ) pooled_threads( pooled, 4 );
+    for ( int i = 0; i < 30000; ++i )
+    {
+        ASSERT_EQ( pooled.at( i ), -i );
+        ASSERT_EQ( pooled_threads.at( i ), -i );
+    }
+    ASSERT_EQ( pooled_copy.size(), 30000u );
+}
+
+/// Data whose copy throws when it holds the poisoned value.
+struct CopyThrows {
+    static int poison;
+    int value;
+    CopyThrows( int v = 0 ) : value{ v } {}
+    CopyThrows( const CopyThrows & other ) : value{ other.value }
+    {
+        if ( value == poison )
+            throw std::runtime_error( "copy" );
+    }
+    CopyThrows( CopyThrows && ) = default;
+    CopyThrows & operator=( const CopyThrows & ) = default;
+};
+int CopyThrows::poison = -1;
+
+TEST(ParallelRehashTest, CopyExceptionsReachTheCaller)
+{
+    ac::HashTbl<int, CopyThrows> htable;
+    for ( int i = 0; i < 30000; ++i )
+        ASSERT_TRUE( htable.try_emplace( i * 7, i * 7 ) );
+    htable.rehash( 200000 );
+
+    // One key in the calling thread's range of buckets, one in the last worker's: the copy
+    // fails on that thread, every thread joins, and the exception reaches the caller.
+    for ( int poison : { 7, 7 * 29999 } )
+    {
+        CopyThrows::poison = poison;
+        for ( std::size_t threads : { 1, 4 } )
+            ASSERT_THROW( ( ac::HashTbl<int, CopyThrows>( htable, threads ) ), std::runtime_error );
+    }
+    CopyThrows::poison = -1;
+    ac::HashTbl<int, CopyThrows> copy( htable, 4 );
+    ASSERT_EQ( copy.size(), 30000u );
+}
+
+TEST(ConcurrentTest, SingleThreadedInterface)
+{
+    ac::ConcurrentHashTbl<std::string, int> htable;
+    ASSERT_TRUE( htable.empty() );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.insert( std::to_string( i ), i ) );
+    ASSERT_FALSE( htable.insert( "7", 70 ) );
+    ASSERT_FALSE( htable.insert_or_assign( "8", 80 ) );
+    ASSERT_EQ( htable.size(), 1000u );
+    ASSERT_LE( htable.load_factor(), htable.max_load_factor() );
+
+    int data = 0;
+    ASSERT_TRUE( htable.retrieve( "7", data ) );
+    ASSERT_EQ( data, 70 );
+    ASSERT_TRUE( htable.update( "8", []( int & d ) { d += 1; } ) );
+    ASSERT_TRUE( htable.retrieve( "8", data ) );
+    ASSERT_EQ( data, 81 );
+    ASSERT_FALSE( htable.update( "x", []( int & d ) { d = 0; } ) );
+
+    ASSERT_TRUE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.contains( "9" ) );
+    htable.rehash( 5000 );
+    ASSERT_GE( htable.bucket_count(), 5000u );
+    ASSERT_TRUE( htable.contains( "999" ) );
+    ASSERT_EQ( htable.size(), 999u );
+    htable.clear();
+    ASSERT_TRUE( htable.empty() );
+    ASSERT_FALSE( htable.contains( "1" ) );
+}
+
+TEST(ConcurrentTest, ParallelWritersReadersAndUpdates)
+{
+    // Small start: the writers force several resizes while the others read and update.
+    ac::ConcurrentHashTbl<int, long> htable;
+    const int writers = 4, per_writer = 5000, counters = 16, increments = 2000;
+    for ( int c = 0; c < counters; ++c )
+        htable.insert( -1 - c, 0 );
+
+    std::vector<std::thread> threads;
+    for ( int w = 0; w < writers; ++w )
+        threads.emplace_back( [&htable, w] {
+            for ( int i = 0; i < per_writer; ++i )
+                htable.insert( w * per_writer + i, i );
+        } );
+    for ( int u = 0; u < 4; ++u )
+        threads.emplace_back( [&htable] {
+            for ( int i = 0; i < increments; ++i )
+                htable.update( -1 - i % counters, []( long & d ) { ++d; } );
+        } );
+    std::atomic<long> seen{ 0 };
+    threads.emplace_back( [&htable, &seen] {
+        long data = 0;
+        for ( int i = 0; i < writers * per_writer; ++i )
+            seen += htable.retrieve( i, data ) && data == i % per_writer;
+    } );
+    for ( auto & t : threads )
+        t.join();
+
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( writers * per_writer + counters ) );
+    for ( int i = 0; i < writers * per_writer; ++i )
+        ASSERT_TRUE( htable.contains( i ) );
+    long total = 0, data = 0;
+    for ( int c = 0; c < counters; ++c )
+    {
+        ASSERT_TRUE( htable.retrieve( -1 - c, data ) );
+        total += data;
+    }
+    ASSERT_EQ( total, 4L * increments );
+}
+
+TEST(ConcurrentTest, CooperativeResizeKeepsEveryKeyVisible)
+{
+    // Preloaded keys must stay visible while writers grow the table and another thread
+    // keeps forcing resizes both ways: lookups follow the forwarding markers.
+    ac::ConcurrentHashTbl<int, int> htable;
+    const int preloaded = 2000, writers = 3, per_writer = 4000;
+    for ( int k = 0; k < preloaded; ++k )
+        htable.insert( -1 - k, k );
+
+    std::atomic<bool> done{ false };
+    std::atomic<long> missing{ 0 };
+    std::vector<std::thread> readers;
+    for ( int r = 0; r < 2; ++r )
+        readers.emplace_back( [&, r] {
+            int data = 0;
+            for ( int k = r; !done.load(); k = (k + 1) % preloaded )
+                if ( !htable.retrieve( -1 - k, data ) || data != k )
+                    ++missing;
+        } );
+
+    std::vector<std::thread> threads;
+    for ( int w = 0; w < writers; ++w )
+        threads.emplace_back( [&htable, w] {
+            for ( int i = 0; i < per_writer; ++i )
+                htable.insert( w * per_writer + i, i );
+        } );
+    threads.emplace_back( [&htable] {
+        for ( std::size_t n : { 5000u, 40000u, 10u, 70000u, 0u } )
+            htable.rehash( n );
+    } );
+    for ( auto & t : threads )
+        t.join();
+    done = true;
+    for ( auto & t : readers )
+        t.join();
+
+    ASSERT_EQ( missing.load(), 0 );
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( preloaded + writers * per_writer ) );
+    int data = 0;
+    for ( int k = 0; k < writers * per_writer; ++k )
+    {
+        ASSERT_TRUE( htable.retrieve( k, data ) );
+        ASSERT_EQ( data, k % per_writer );
+    }
+    htable.clear();
+    ASSERT_TRUE( htable.empty() );
+}
+
+TEST(ConcurrentTest, RetiredLayoutsOutliveTheirReaders)
+{
+    // Every resize retires a layout while readers may still hold one of its stripes; the
+    // sanitizer builds catch a layout freed under them.
+    ac::ConcurrentHashTbl<int, int> htable;
+    const int keys = 1000;
+    for ( int k = 0; k < keys; ++k )
+        htable.insert( k, -k );
+
+    std::atomic<bool> done{ false };
+    std::atomic<long> missing{ 0 };
+    std::vector<std::thread> readers;
+    for ( int r = 0; r < 3; ++r )
+        readers.emplace_back( [&, r] {
+            int data = 0;
+            for ( int k = r; !done.load(); k = (k + 1) % keys )
+                if ( !htable.retrieve( k, data ) || data != -k || htable.bucket_count() == 0 )
+                    ++missing;
+        } );
+
+    for ( int round = 0; round < 200; ++round )
+    {
+        htable.rehash( round % 2 == 0 ? 8000 : 0 );
+        ac::EpochDomain::global().collect();
+    }
+    done = true;
+    for ( auto & t : readers )
+        t.join();
+
+    ASSERT_EQ( missing.load(), 0 );
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( keys ) );
+}
+
+std::atomic<int> epoch_freed{ 0 };
+
+TEST(EpochTest, RetiredObjectsWaitForPinnedThreads)
+{
+    ac::EpochDomain & domain = ac::EpochDomain::global();
+    auto free_int = []( void * p ) { delete static_cast<int *>( p ); ++epoch_freed; };
+    epoch_freed = 0;
+    {
+        // While this thread stays pinned the epoch advances at most once: nothing is freed.
+        ac::EpochGuard pin;
+        for ( int i = 0; i < 1000; ++i )
+            domain.retire( new int( i ), free_int );
+        domain.collect();
+        domain.collect();
+        ASSERT_EQ( epoch_freed.load(), 0 );
+    }
+
+    // Threads retire concurrently, each collecting in turn without waiting for the others.
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t )
+    {
+        threads.emplace_back( [&] {
+            for ( int i = 0; i < 1000; ++i )
+            {
+                ac::EpochGuard pin;
+                domain.retire( new int( i ), free_int );
+            }
+        } );
+    }
+    for ( auto & t : threads )
+        t.join();
+
+    // Unpinned, two advances free everything.
+    for ( int i = 0; i < 3; ++i )
+        domain.collect();
+    ASSERT_EQ( epoch_freed.load(), 5000 );
+}
+
+TEST(ReadMostlyTest, SingleThreadedInterface)
+{
+    ac::ReadMostlyHashTbl<std::string, int> htable;
+    ASSERT_TRUE( htable.empty() );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.insert( std::to_string( i ), i ) );
+    ASSERT_FALSE( htable.insert( "7", 70 ) );
+    ASSERT_FALSE( htable.insert_or_assign( "8", 80 ) );
+    ASSERT_EQ( htable.size(), 1000u );
+    ASSERT_LE( htable.load_factor(), htable.max_load_factor() );
+
+    int data = 0;
+    ASSERT_TRUE( htable.retrieve( "7", data ) );
+    ASSERT_EQ( data, 70 );
+    ASSERT_TRUE( htable.update( "8", []( int & d ) { d += 1; } ) );
+    ASSERT_TRUE( htable.visit( "8", [&data]( const int & d ) { data = d; } ) );
+    ASSERT_EQ( data, 81 );
+    ASSERT_FALSE( htable.update( "x", []( int & d ) { d = 0; } ) );
+    ASSERT_FALSE( htable.visit( "x", []( const int & ) { FAIL(); } ) );
+
+    ASSERT_TRUE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.contains( "9" ) );
+    htable.rehash( 5000 );
+    ASSERT_GE( htable.bucket_count(), 5000u );
+    ASSERT_TRUE( htable.contains( "999" ) );
+    ASSERT_EQ( htable.size(), 999u );
+    htable.clear();
+    ASSERT_TRUE( htable.empty() );
+    ASSERT_FALSE( htable.contains( "1" ) );
+}
+
+TEST(ReadMostlyTest, ReadersSeeConsistentDataDuringWrites)
+{
+    // Data is always a function of the key, so a reader can check every hit on its own:
+    // a torn or freed node would break the relation (and trip the sanitizers).
+    ac::ReadMostlyHashTbl<int, std::string> htable;
+    const int keys = 4000, rounds = 3;
+    auto value = []( int k, int r ) { return std::to_string( k ) + "/" + std::to_string( r ); };
+    for ( int k = 0; k < keys; k += 2 )
+        htable.insert( k, value( k, 0 ) );
+
+    std::atomic<bool> done{ false };
+    std::atomic<long> bad{ 0 };
+    std::vector<std::thread> readers;
+    for ( int t = 0; t < 3; ++t )
+        readers.emplace_back( [&, t] {
+            std::string data;
+            for ( int i = t; !done.load(); i = (i + 7) % keys )
+                if ( htable.retrieve( i, data ) && data.compare( 0, data.find( '/' ), std::to_string( i ) ) != 0 )
+                    ++bad;
+        } );
+
+    std::vector<std::thread> writers;
+    writers.emplace_back( [&] {
+        for ( int r = 1; r <= rounds; ++r )
+            for ( int k = 1; k < keys; k += 2 )
+                htable.insert_or_assign( k, value( k, r ) );
+    } );
+    writers.emplace_back( [&] {
+        for ( int r = 1; r <= rounds; ++r )
+        {
+            for ( int k = 0; k < keys; k += 4 )
+                htable.update( k, [&]( std::string & d ) { d = value( k, r ); } );
+            htable.rehash( htable.bucket_count() * 2 );
+        }
+    } );
+    writers.emplace_back( [&] {
+        for ( int k = 2; k < keys; k += 4 )
+            htable.erase( k );
+    } );
+    for ( auto & t : writers )
+        t.join();
+    done = true;
+    for ( auto & t : readers )
+        t.join();
+
+    ASSERT_EQ( bad.load(), 0 );
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( keys / 2 + keys / 4 ) );
+    std::string data;
+    for ( int k = 0; k < keys; ++k )
+    {
+        const bool present = k % 2 == 1 || k % 4 == 0;
+        ASSERT_EQ( htable.retrieve( k, data ), present );
+        if ( present )
+        {
+            ASSERT_EQ( data, value( k, rounds ) );
+        }
+    }
+}
+
+TEST(LockFreeTest, SingleThreadedInterface)
+{
+    ac::LockFreeHashTbl<std::string, int> htable( 2 );
+    ASSERT_TRUE( htable.empty() );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.insert( std::to_string( i ), i ) );
+    ASSERT_FALSE( htable.insert( "7", 70 ) );
+    ASSERT_FALSE( htable.insert_or_assign( "8", 80 ) );
+    ASSERT_EQ( htable.size(), 1000u );
+    // Growth only doubled the index, starting from 2 buckets.
+    ASSERT_GE( htable.bucket_count(), 512u );
+    ASSERT_EQ( htable.bucket_count() & (htable.bucket_count() - 1), 0u );
+    ASSERT_LE( htable.load_factor(), 2 * htable.max_load_factor() );
+
+    int data = 0;
+    ASSERT_TRUE( htable.retrieve( "7", data ) );
+    ASSERT_EQ( data, 70 );
+    ASSERT_TRUE( htable.retrieve( "8", data ) );
+    ASSERT_EQ( data, 80 );
+    ASSERT_FALSE( htable.retrieve( "x", data ) );
+
+    ASSERT_TRUE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.contains( "9" ) );
+    ASSERT_TRUE( htable.insert( "9", 9 ) );
+    htable.reserve( 5000 );
+    ASSERT_GE( htable.bucket_count(), 5000u );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.contains( std::to_string( i ) ) );
+    ASSERT_EQ( htable.size(), 1000u );
+}
+
+TEST(LockFreeTest, ParallelInsertEraseAndLookups)
+{
+    // Starts tiny so the index doubles many times under the writers.
+    ac::LockFreeHashTbl<int, std::string> htable( 2 );
+    const int writers = 4, per_writer = 5000;
+    std::atomic<bool> done{ false };
+    std::atomic<long> bad{ 0 };
+
+    std::vector<std::thread> threads;
+    for ( int w = 0; w < writers; ++w )
+        threads.emplace_back( [&, w] {
+            for ( int i = 0; i < per_writer; ++i )
+                htable.insert( w * per_writer + i, std::to_string( w * per_writer + i ) );
+            // Every writer erases a third of its keys and rewrites another third.
+            for ( int i = 0; i < per_writer; i += 3 )
+                htable.erase( w * per_writer + i );
+            for ( int i = 1; i < per_writer; i += 3 )
+                htable.insert_or_assign( w * per_writer + i, std::to_string( -(w * per_writer + i) ) );
+        } );
+    std::thread reader( [&] {
+        std::string data;
+        for ( int i = 0; !done.load(); i = (i + 1) % (writers * per_writer) )
+            if ( htable.retrieve( i, data ) && std::abs( std::stoi( data ) ) != i )
+                ++bad;
+    } );
+    for ( auto & t : threads )
+        t.join();
+    done = true;
+    reader.join();
+
+    ASSERT_EQ( bad.load(), 0 );
+    int expected = 0;
+    std::string data;
+    for ( int k = 0; k < writers * per_writer; ++k )
+    {
+        const int i = k % per_writer;
+        ASSERT_EQ( htable.retrieve( k, data ), i % 3 != 0 );
+        if ( i % 3 == 1 )
+        {
+            ASSERT_EQ( data, std::to_string( -k ) );
+        }
+        if ( i % 3 == 2 )
+        {
+            ASSERT_EQ( data, std::to_string( k ) );
+        }
+        expected += i % 3 != 0;
+    }
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( expected ) );
+}
+
+TEST(AtomicTest, SingleThreadedInterface)
+{
+    // Small first sub-map, so the keys spill over into chained ones.
+    ac::AtomicHashTbl<int, long> htable( 16 );
+    ASSERT_TRUE( htable.empty() );
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_TRUE( htable.insert( i, i ) );
+    ASSERT_FALSE( htable.insert( 7, 70 ) );
+    ASSERT_FALSE( htable.insert_or_assign( 8, 80 ) );
+    ASSERT_EQ( htable.size(), 5000u );
+    ASSERT_GT( htable.sub_maps(), 1u );
+    ASSERT_GE( htable.capacity(), 5000u );
+
+    long data = 0;
+    ASSERT_TRUE( htable.retrieve( 7, data ) );
+    ASSERT_EQ( data, 70 );
+    ASSERT_EQ( htable.fetch_add( 8, 5 ), 80 );
+    ASSERT_TRUE( htable.retrieve( 8, data ) );
+    ASSERT_EQ( data, 85 );
+    ASSERT_EQ( htable.fetch_add( -5, 3 ), 0 ); // Inserts the key with 0 first.
+    ASSERT_EQ( htable.size(), 5001u );
+
+    ASSERT_TRUE( htable.erase( 9 ) );
+    ASSERT_FALSE( htable.erase( 9 ) );
+    ASSERT_FALSE( htable.contains( 9 ) );
+    ASSERT_TRUE( htable.insert( 9, 90 ) );
+    ASSERT_TRUE( htable.retrieve( 9, data ) );
+    ASSERT_EQ( data, 90 );
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_TRUE( htable.contains( i ) );
+    ASSERT_FALSE( htable.contains( 5000 ) );
+}
+
+TEST(AtomicTest, ReservedKeysAreRejected)
+{
+    using Table = ac::AtomicHashTbl<int, long>;
+    Table htable;
+    htable.insert( 1, 10 );
+
+    // The three largest ints mark empty, locked and erased slots: they cannot be stored,
+    // and looking them up never matches a slot in one of those states.
+    for ( int key : { Table::EMPTY_KEY, Table::LOCKED_KEY, Table::ERASED_KEY } )
+    {
+        ASSERT_THROW( htable.insert( key, 1 ), std::invalid_argument );
+        ASSERT_THROW( htable.fetch_add( key, 1 ), std::invalid_argument );
+        ASSERT_FALSE( htable.contains( key ) );
+        long data = 0;
+        ASSERT_FALSE( htable.retrieve( key, data ) );
+        ASSERT_FALSE( htable.erase( key ) );
+    }
+    ASSERT_EQ( htable.size(), 1u );
+
+    // The largest storable key sits right below them, and the table stays usable.
+    ASSERT_TRUE( htable.insert( Table::ERASED_KEY - 1, 20 ) );
+    ASSERT_TRUE( htable.contains( Table::ERASED_KEY - 1 ) );
+    ASSERT_TRUE( htable.erase( 1 ) );
+    ASSERT_TRUE( htable.insert( 1, 30 ) );
+    ASSERT_EQ( htable.size(), 2u );
+}
+
+TEST(AtomicTest, ParallelCountersAndInserts)
+{
+    // Counters keyed by account number, bumped from every thread while others insert.
+    ac::AtomicHashTbl<int, long> htable( 16 );
+    const int threads_n = 4, accounts = 500, increments = 4000, per_inserter = 3000;
+
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < threads_n; ++t )
+        threads.emplace_back( [&htable, t] {
+            for ( int i = 0; i < increments; ++i )
+                htable.fetch_add( (i * 7 + t) % accounts, 1 );
+        } );
+    for ( int t = 0; t < threads_n; ++t )
+        threads.emplace_back( [&htable, t] {
+            for ( int i = 0; i < per_inserter; ++i )
+                htable.insert( accounts + t * per_inserter + i, i );
+        } );
+    for ( auto & t : threads )
+        t.join();
+
+    long total = 0, data = 0;
+    for ( int a = 0; a < accounts; ++a )
+    {
+        ASSERT_TRUE( htable.retrieve( a, data ) );
+        total += data;
+    }
+    ASSERT_EQ( total, static_cast<long>( threads_n ) * increments );
+    for ( int k = 0; k < threads_n * per_inserter; ++k )
+    {
+        ASSERT_TRUE( htable.retrieve( accounts + k, data ) );
+        ASSERT_EQ( data, k % per_inserter );
+    }
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( accounts + threads_n * per_inserter ) );
+}
+
+TEST(ShardedTest, SingleThreadedInterface)
+{
+    ac::ShardedHashTbl<std::string, int, std::hash<std::string>, std::equal_to<std::string>, 8> htable;
+    ASSERT_TRUE( htable.empty() );
+    for ( int i = 0; i < 1000; ++i )
+        ASSERT_TRUE( htable.insert( std::to_string( i ), i ) );
+    ASSERT_FALSE( htable.insert( "7", 70 ) );
+    ASSERT_FALSE( htable.insert_or_assign( "8", 80 ) );
+    ASSERT_EQ( htable.size(), 1000u );
+
+    int data = 0;
+    ASSERT_TRUE( htable.retrieve( "7", data ) );
+    ASSERT_EQ( data, 70 );
+    ASSERT_TRUE( htable.update( "8", []( int & d ) { d += 1; } ) );
+    ASSERT_TRUE( htable.retrieve( "8", data ) );
+    ASSERT_EQ( data, 81 );
+    ASSERT_FALSE( htable.update( "x", []( int & d ) { d = 0; } ) );
+
+    ASSERT_TRUE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.erase( "9" ) );
+    ASSERT_FALSE( htable.contains( "9" ) );
+    ASSERT_EQ( htable.size(), 999u );
+
+    // Every key sits in the shard its hash routes it to, and the shards share the load.
+    std::size_t seen = 0;
+    htable.for_each_shard( [&seen]( std::size_t s, const auto & shard ) {
+        ASSERT_GT( shard.size(), 0u );
+        for ( const auto & e : shard )
+            ASSERT_EQ( decltype(htable)::shard_of( e.m_key ), s );
+        seen += shard.size();
+    } );
+    ASSERT_EQ( seen, 999u );
+
+    // The mutable overload may change shards; the counts follow.
+    htable.for_each_shard( []( std::size_t, auto & shard ) { shard.erase( "1" ); } );
+    ASSERT_EQ( htable.size(), 998u );
+    htable.clear();
+    ASSERT_TRUE( htable.empty() );
+    ASSERT_FALSE( htable.contains( "2" ) );
+}
+
+TEST(ShardedTest, ParallelWritersAndShardScans)
+{
+    ac::ShardedHashTbl<int, long> htable;
+    const int writers = 4, per_writer = 5000, counters = 16, increments = 2000;
+    for ( int c = 0; c < counters; ++c )
+        htable.insert( -1 - c, 0 );
+
+    std::vector<std::thread> threads;
+    for ( int w = 0; w < writers; ++w )
+        threads.emplace_back( [&htable, w] {
+            for ( int i = 0; i < per_writer; ++i )
+                htable.insert( w * per_writer + i, i );
+        } );
+    for ( int u = 0; u < 2; ++u )
+        threads.emplace_back( [&htable] {
+            for ( int i = 0; i < increments; ++i )
+                htable.update( -1 - i % counters, []( long & d ) { ++d; } );
+        } );
+    threads.emplace_back( [&htable] {
+        // Concurrent scans only ever see whole shards.
+        for ( int r = 0; r < 20; ++r )
+            htable.for_each_shard( []( std::size_t, const auto & shard ) {
+                for ( const auto & e : shard )
+                    ASSERT_TRUE( e.m_key < 0 || e.m_data == e.m_key % per_writer );
+            }, 2 );
+    } );
+    for ( auto & t : threads )
+        t.join();
+
+    ASSERT_EQ( htable.size(), static_cast<std::size_t>( writers * per_writer + counters ) );
+    std::atomic<long> total{ 0 };
+    htable.for_each_shard( [&total]( std::size_t, const auto & shard ) {
+        for ( const auto & e : shard )
+            total += e.m_key < 0 ? e.m_data : 0;
+    }, 4 );
+    ASSERT_EQ( total.load(), 2L * increments );
+}
+
+TEST(ShardedTest, ShardScanThreadsAndExceptions)
+{
+    ac::ShardedHashTbl<int, int> htable;
+    for ( int i = 0; i < 1000; ++i )
+        htable.insert( i, i );
+
+    // Zero threads means one per hardware thread: every shard is still visited once.
+    std::atomic<std::size_t> visited{ 0 }, seen{ 0 };
+    htable.for_each_shard( [&]( std::size_t, const auto & shard ) { ++visited; seen += shard.size(); }, 0 );
+    ASSERT_EQ( visited.load(), decltype(htable)::SHARDS );
+    ASSERT_EQ( seen.load(), 1000u );
+
+    // An exception from fn_, on the calling thread or a worker, stops the scan and reaches
+    // the caller once every thread has joined; the table stays usable.
+    for ( std::size_t threads : { 1, 4, 0 } )
+    {
+        ASSERT_THROW( htable.for_each_shard( []( std::size_t s, auto & ) {
+            if ( s >= 2 )
+                throw std::runtime_error( "stop" );
+        }, threads ), std::runtime_error );
+    }
+    ASSERT_TRUE( htable.insert( 5000, 1 ) );
+    ASSERT_EQ( htable.size(), 1001u );
+
+    // A shard changed before fn_ throws is still counted as it was left.
+    std::size_t dropped = 0;
+    ASSERT_THROW( htable.for_each_shard( [&]( std::size_t, auto & shard ) {
+        dropped = shard.size();
+        shard.clear();
+        throw std::runtime_error( "stop" );
+    } ), std::runtime_error );
+    ASSERT_GT( dropped, 0u );
+    ASSERT_EQ( htable.size(), 1001u - dropped );
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
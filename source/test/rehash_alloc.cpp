@@ -0,0 +1,145 @@
+#include <atomic>
+#include <cstdlib>              // std::malloc, std::free
+#include <functional>           // std::hash, std::equal_to
+#include <memory>               // std::allocator
+#include <new>                  // std::bad_alloc
+
+#include "../googletest-main/googletest/include/gtest/gtest.h"        // gtest lib
+#include "../include/hashtbl.h"
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+// The global operator new is replaced for the whole program, which is why these tests have
+// an executable of their own.
+
+/// Calls to the global operator new, scalar or array. Atomic: parallel rehashes allocate too.
+std::atomic<std::size_t> global_allocations{ 0 };
+
+void * counted_malloc( std::size_t n_ )
+{
+    global_allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void * p = std::malloc( n_ == 0 ? 1 : n_ ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+void * operator new( std::size_t n_ ) { return counted_malloc( n_ ); }
+void * operator new[]( std::size_t n_ ) { return counted_malloc( n_ ); }
+void operator delete( void * p_ ) noexcept { std::free( p_ ); }
+void operator delete( void * p_, std::size_t ) noexcept { std::free( p_ ); }
+void operator delete[]( void * p_ ) noexcept { std::free( p_ ); }
+void operator delete[]( void * p_, std::size_t ) noexcept { std::free( p_ ); }
+
+/// Key or data that counts its copies and moves.
+struct Tracked {
+    static int copies, moves;
+    int value;
+    explicit Tracked( int v = 0 ) : value{ v } {}
+    Tracked( const Tracked & other ) : value{ other.value } { ++copies; }
+    Tracked( Tracked && other ) noexcept : value{ other.value } { ++moves; }
+    Tracked & operator=( const Tracked & other ) { value = other.value; ++copies; return *this; }
+    Tracked & operator=( Tracked && other ) noexcept { value = other.value; ++moves; return *this; }
+    bool operator==( const Tracked & other ) const { return value == other.value; }
+};
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+struct TrackedHash {
+    std::size_t operator()( const Tracked & t ) const { return std::hash<int>()( t.value ); }
+};
+
+/// Stateless allocator that counts the nodes it hands out and takes back.
+struct NodeCount { static int allocations, deallocations; };
+int NodeCount::allocations = 0;
+int NodeCount::deallocations = 0;
+
+template < class T >
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template < class U >
+    CountingAllocator( const CountingAllocator<U> & ) {}
+    T * allocate( std::size_t n ) { ++NodeCount::allocations; return std::allocator<T>().allocate( n ); }
+    void deallocate( T * p, std::size_t n ) { ++NodeCount::deallocations; std::allocator<T>().deallocate( p, n ); }
+    template < class U >
+    bool operator==( const CountingAllocator<U> & ) const { return true; }
+    template < class U >
+    bool operator!=( const CountingAllocator<U> & ) const { return false; }
+};
+
+using tracked_table = ac::HashTbl<Tracked, Tracked, TrackedHash, std::equal_to<Tracked>, ac::PrimeModPolicy,
+                                  ac::LoadFactorPolicy, CountingAllocator<ac::HashEntry<Tracked, Tracked>>>;
+
+TEST(RelinkingRehashTest, SerialRehashAllocatesOnce)
+{
+    tracked_table htable;
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_TRUE( htable.try_emplace( Tracked( i ), -i ) );
+
+    // Growing and shrinking: the only allocation is the block of the bucket array and its
+    // occupancy bitmap; no node is allocated or freed and every entry stays in its node.
+    for ( std::size_t n : { 100000, 0, 50000, 0 } )
+    {
+        Tracked::copies = Tracked::moves = 0;
+        NodeCount::allocations = NodeCount::deallocations = 0;
+        const std::size_t before = global_allocations;
+        const auto buckets = htable.bucket_count();
+
+        htable.rehash( n );
+        ASSERT_NE( htable.bucket_count(), buckets );
+        ASSERT_EQ( global_allocations - before, 1u );
+        ASSERT_EQ( NodeCount::allocations, 0 );
+        ASSERT_EQ( NodeCount::deallocations, 0 );
+        ASSERT_EQ( Tracked::copies, 0 );
+        ASSERT_EQ( Tracked::moves, 0 );
+    }
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_EQ( htable.at( Tracked( i ) ).value, -i );
+}
+
+TEST(RelinkingRehashTest, ParallelRehashRelinks)
+{
+    tracked_table htable;
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_TRUE( htable.try_emplace( Tracked( i ), -i ) );
+
+    // On threads the scratch lists and the threads themselves are allocated as well, so only
+    // the nodes and the entries are checked here.
+    for ( std::size_t n : { 100000, 0 } )
+    {
+        Tracked::copies = Tracked::moves = 0;
+        NodeCount::allocations = NodeCount::deallocations = 0;
+        const auto buckets = htable.bucket_count();
+
+        htable.rehash( n, 3 );
+        ASSERT_NE( htable.bucket_count(), buckets );
+        ASSERT_EQ( NodeCount::allocations, 0 );
+        ASSERT_EQ( NodeCount::deallocations, 0 );
+        ASSERT_EQ( Tracked::copies, 0 );
+        ASSERT_EQ( Tracked::moves, 0 );
+    }
+    for ( int i = 0; i < 5000; ++i )
+        ASSERT_EQ( htable.at( Tracked( i ) ).value, -i );
+}
+
+TEST(RelinkingRehashTest, GrowthAndMigrationRelink)
+{
+    tracked_table htable;
+    htable.incremental_rehash( true, 1 );
+
+    // Growth on insertion and the steps of an incremental migration relink nodes too.
+    Tracked::copies = Tracked::moves = 0;
+    for ( int i = 0; i < 15000; ++i )
+        ASSERT_TRUE( htable.try_emplace( Tracked( i ), -i ) );
+    ASSERT_EQ( Tracked::copies, 0 );
+    ASSERT_EQ( Tracked::moves, 15000 ); // The key of each new entry, moved into its node.
+    for ( int i = 0; i < 15000; ++i )
+        ASSERT_EQ( htable.at( Tracked( i ) ).value, -i );
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}